@@ -21,6 +21,9 @@ struct LayerMode
 {
     struct Raw {};
     struct Train {};
+    struct Quantized {};
+    struct Sparse {};
+    struct Fused {};
 };
 
 struct LayerType
@@ -30,6 +33,13 @@ struct LayerType
     struct MaxPooling {};
 };
 
+struct ComputeType
+{
+    struct Native {};
+    struct BFloat16 {};
+    struct Half {};
+};
+
 struct RangeType
 {
     struct View {};
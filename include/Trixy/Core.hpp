@@ -19,8 +19,10 @@
 namespace trixy
 {
 
-// Special struct for types alias
-template <typename Precision>
+// Special struct for types alias.
+// Compute is a precision of the layer products, e.g. ComputeType::BFloat16 for the mixed precision:
+// weights, gradients and optimizer states are kept in Precision
+template <typename Precision, typename Compute = ComputeType::Native>
 struct TypeSet
 {
     template <typename T>
@@ -30,9 +32,14 @@ struct TypeSet
     using Matrix            = lique::Matrix<Precision>;
     using Tensor            = lique::Tensor<Precision>;
 
+    using VectorView        = lique::VectorView<Precision>;
+    using MatrixView        = lique::MatrixView<Precision>;
+    using TensorView        = lique::TensorView<Precision>;
+
     using Linear            = lique::Linear<Precision>;
 
     using precision_type    = Precision;
+    using compute_type      = Compute;
     using size_type         = std::size_t;
 };
 
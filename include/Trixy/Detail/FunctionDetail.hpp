@@ -3,8 +3,11 @@
 
 #include <cmath> // sqrt
 #include <cstddef> // size_t
+#include <cstdint> // uint16_t, uint32_t
+#include <cstring> // memcpy
 #include <thread> // thread
 #include <tuple> // pair
+#include <vector> // vector
 
 #include <Trixy/Detail/TrixyMeta.hpp>
 
@@ -35,6 +38,27 @@ std::pair<std::size_t, std::size_t> parallel_info(std::size_t size)
     return { number_of_threads, block_size };
 }
 
+/// Function split range [0, size) by blocks from parallel_info and call function(first, last, thread)
+/// for each of them, every additional thread takes own copy of function,
+/// the last block will process on the calling thread
+template <class Function>
+void parallel_for(std::pair<std::size_t, std::size_t> info, std::size_t size, Function function)
+{
+    const std::size_t number_of_threads = info.first;
+    const std::size_t block_size = info.second;
+
+    std::vector<std::thread> threads;
+    threads.reserve(number_of_threads - 1);
+
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < number_of_threads - 1; ++i, first += block_size)
+        threads.emplace_back(function, first, first + block_size, i);
+
+    function(first, size, number_of_threads - 1);
+
+    for (auto& thread : threads) thread.join();
+}
+
 template <typename To, typename Alt = To, typename From,
           meta::require<std::is_convertible<From, To>::value> = 0>
 constexpr To try_cast(From&& from)
@@ -55,6 +79,103 @@ Precision invert_sqrt(Precision x) noexcept
     return 1. / std::sqrt(1e-9 + x);
 }
 
+/// IEEE 754 half precision, round to nearest even
+inline std::uint16_t float_to_half(float value) noexcept
+{
+    std::uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+
+    const std::uint32_t sign = (x >> 16) & 0x8000u;
+    std::uint32_t mantissa = x & 0x007FFFFFu;
+    const int exponent = static_cast<int>((x >> 23) & 0xFFu) - 127 + 15;
+
+    if ((x & 0x7FFFFFFFu) >= 0x7F800000u) // inf or nan
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+
+    if (exponent >= 31) return static_cast<std::uint16_t>(sign | 0x7C00u); // overflow
+
+    if (exponent <= 0) // subnormal or zero
+    {
+        if (exponent < -10) return static_cast<std::uint16_t>(sign);
+
+        mantissa |= 0x00800000u;
+
+        const unsigned shift = static_cast<unsigned>(14 - exponent);
+        const std::uint32_t rest = mantissa & ((1u << shift) - 1u);
+        const std::uint32_t halfway = 1u << (shift - 1u);
+
+        std::uint32_t half = mantissa >> shift;
+        if (rest > halfway || (rest == halfway && (half & 1u))) ++half;
+
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    std::uint32_t half = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const std::uint32_t rest = mantissa & 0x1FFFu;
+
+    // carry to the exponent gives correct rounding up to inf
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;
+
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+inline float half_to_float(std::uint16_t value) noexcept
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(value & 0x8000u) << 16;
+    std::uint32_t mantissa = value & 0x03FFu;
+    int exponent = (value >> 10) & 0x1F;
+
+    std::uint32_t x;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0) x = sign;
+        else // subnormal, normalize it
+        {
+            exponent = 1;
+            while ((mantissa & 0x0400u) == 0)
+            {
+                mantissa <<= 1;
+                --exponent;
+            }
+
+            mantissa &= 0x03FFu;
+            x = sign | (static_cast<std::uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+    }
+    else if (exponent == 31) x = sign | 0x7F800000u | (mantissa << 13);
+    else x = sign | (static_cast<std::uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+
+    float result;
+    std::memcpy(&result, &x, sizeof(result));
+
+    return result;
+}
+
+/// Brain floating point: upper half of float, round to nearest even
+inline std::uint16_t float_to_bfloat(float value) noexcept
+{
+    std::uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+
+    if ((x & 0x7FFFFFFFu) > 0x7F800000u) // quiet nan
+        return static_cast<std::uint16_t>((x >> 16) | 0x40u);
+
+    x += 0x7FFFu + ((x >> 16) & 1u);
+
+    return static_cast<std::uint16_t>(x >> 16);
+}
+
+inline float bfloat_to_float(std::uint16_t value) noexcept
+{
+    const std::uint32_t x = static_cast<std::uint32_t>(value) << 16;
+
+    float result;
+    std::memcpy(&result, &x, sizeof(result));
+
+    return result;
+}
+
 template <typename Pointer>
 inline const char* const_byte_cast(Pointer* ptr) noexcept
 {
@@ -9,6 +9,9 @@
 #include <Trixy/Lique/Tensor.hpp>
 
 #include <Trixy/Lique/Linear.hpp>
+#include <Trixy/Lique/Reduced.hpp>
+#include <Trixy/Lique/Quantized.hpp>
+#include <Trixy/Lique/Sparse.hpp>
 
 #include <Trixy/Lique/Tool.hpp>
 
@@ -1,13 +1,17 @@
 #ifndef TRIXY_LIQUE_LINEAR_HPP
 #define TRIXY_LIQUE_LINEAR_HPP
 
+#include <cmath> // fabs, sqrt
 #include <cstddef> // size_t
+#include <vector> // vector
 
 #include <Trixy/Require/Linear.hpp>
 
 #include <Trixy/Lique/Detail/FunctionDetail.hpp>
 #include <Trixy/Lique/Detail/LiqueMeta.hpp>
 
+#include <Trixy/Detail/FunctionDetail.hpp>
+
 #include <Trixy/Detail/MetaMacro.hpp>
 
 namespace trixy
@@ -209,6 +213,223 @@ public:
         }
     }
 
+    // In place LU factorization with partial pivoting PA = LU, L has unit diagonal.
+    // Row i was swapped with pivots[i], pivots MUST have N elements.
+    // Return false if matrix is singular. Trailing update runs in parallel, so it isn't noexcept
+    template <class Matrix,
+              meta::as_matrix<Matrix> = 0>
+    bool lu(
+        Matrix& matrix,
+        size_type* pivots) const
+    {
+        const size_type N = matrix.shape().height;
+        precision_type* a = matrix.data();
+
+        for (size_type k0 = 0; k0 < N; k0 += factorization_block)
+        {
+            const size_type k1 = k0 + factorization_block < N ? k0 + factorization_block : N;
+
+            // panel [k0, N) x [k0, k1)
+            for (size_type k = k0; k < k1; ++k)
+            {
+                size_type p = k;
+                for (size_type i = k + 1; i < N; ++i)
+                    if (std::fabs(a[i * N + k]) > std::fabs(a[p * N + k])) p = i;
+
+                if (a[p * N + k] == precision_type(0)) return false;
+
+                pivots[k] = p;
+                if (p != k) swap_rows(a + k * N, a + p * N, N);
+
+                const precision_type inverse_pivot = precision_type(1) / a[k * N + k];
+
+                for (size_type i = k + 1; i < N; ++i)
+                {
+                    precision_type* row = a + i * N;
+
+                    row[k] *= inverse_pivot;
+                    for (size_type j = k + 1; j < k1; ++j) row[j] -= row[k] * a[k * N + j];
+                }
+            }
+
+            if (k1 == N) break;
+
+            // U12 = L11^(-1) . A12
+            for (size_type k = k0; k < k1; ++k)
+                for (size_type i = k + 1; i < k1; ++i)
+                    axpy(a + i * N + k1, a + N * i + N, -a[i * N + k], a + k * N + k1);
+
+            // A22 -= L21 . U12
+            update(N - k1, (N - k1) * (N - k1) * (k1 - k0), [a, N, k0, k1](size_type first, size_type last)
+            {
+                for (size_type i = k1 + first; i < k1 + last; ++i)
+                    for (size_type k = k0; k < k1; ++k)
+                        axpy(a + i * N + k1, a + i * N + N, -a[i * N + k], a + k * N + k1);
+            });
+        }
+
+        return true;
+    }
+
+    // Solve A . X = B in place of rhs by the lu() result, rhs is vector or matrix with N rows
+    template <class Matrix, class Rhs,
+              meta::as_matrix<Matrix> = 0,
+              meta::as_iterate<Rhs> = 0>
+    void lu_solve(
+        const Matrix& lu,
+        const size_type* pivots,
+        Rhs& rhs) const noexcept
+    {
+        const size_type N = lu.shape().height;
+        const size_type M = rhs.size() / N;
+
+        const precision_type* a = lu.data();
+        precision_type* b = rhs.data();
+
+        for (size_type k = 0; k < N; ++k)
+            if (pivots[k] != k) swap_rows(b + k * M, b + pivots[k] * M, M);
+
+        // L . Y = P . B
+        for (size_type i = 0; i < N; ++i)
+            for (size_type k = 0; k < i; ++k)
+                axpy(b + i * M, b + i * M + M, -a[i * N + k], b + k * M);
+
+        // U . X = Y
+        for (size_type i = N; i-- > 0;)
+        {
+            for (size_type k = i + 1; k < N; ++k)
+                axpy(b + i * M, b + i * M + M, -a[i * N + k], b + k * M);
+
+            const precision_type inverse_pivot = precision_type(1) / a[i * N + i];
+            for (size_type j = 0; j < M; ++j) b[i * M + j] *= inverse_pivot;
+        }
+    }
+
+    // In place Cholesky factorization A = L . L^T of the symmetric positive definite matrix,
+    // upper triangle is set to zero. Return false if matrix isn't positive definite.
+    // Trailing update runs in parallel, so it isn't noexcept
+    template <class Matrix,
+              meta::as_matrix<Matrix> = 0>
+    bool cholesky(Matrix& matrix) const
+    {
+        const size_type N = matrix.shape().height;
+        precision_type* a = matrix.data();
+
+        for (size_type k0 = 0; k0 < N; k0 += factorization_block)
+        {
+            const size_type k1 = k0 + factorization_block < N ? k0 + factorization_block : N;
+
+            // L11 . L11^T = A11
+            for (size_type j = k0; j < k1; ++j)
+            {
+                const precision_type diagonal = a[j * N + j] - inner(a + j * N + k0, a + j * N + j, a + j * N + k0);
+                if (not (diagonal > precision_type(0))) return false;
+
+                a[j * N + j] = std::sqrt(diagonal);
+
+                for (size_type i = j + 1; i < k1; ++i)
+                    a[i * N + j] = (a[i * N + j] - inner(a + i * N + k0, a + i * N + j, a + j * N + k0)) / a[j * N + j];
+            }
+
+            if (k1 == N) break;
+
+            // L21 = A21 . L11^(-T), A22 -= L21 . L21^T
+            update(N - k1, (N - k1) * (N - k1) * (k1 - k0) / 2, [a, N, k0, k1](size_type first, size_type last)
+            {
+                for (size_type i = k1 + first; i < k1 + last; ++i)
+                    for (size_type j = k0; j < k1; ++j)
+                        a[i * N + j] = (a[i * N + j] - inner(a + i * N + k0, a + i * N + j, a + j * N + k0)) / a[j * N + j];
+            });
+
+            update(N - k1, (N - k1) * (N - k1) * (k1 - k0) / 2, [a, N, k0, k1](size_type first, size_type last)
+            {
+                for (size_type i = k1 + first; i < k1 + last; ++i)
+                    for (size_type j = k1; j <= i; ++j)
+                        a[i * N + j] -= inner(a + i * N + k0, a + i * N + k1, a + j * N + k0);
+            });
+        }
+
+        for (size_type i = 0; i < N; ++i)
+            for (size_type j = i + 1; j < N; ++j) a[i * N + j] = precision_type(0);
+
+        return true;
+    }
+
+    // Solve A . X = B in place of rhs by the cholesky() result, rhs is vector or matrix with N rows
+    template <class Matrix, class Rhs,
+              meta::as_matrix<Matrix> = 0,
+              meta::as_iterate<Rhs> = 0>
+    void cholesky_solve(
+        const Matrix& cholesky,
+        Rhs& rhs) const noexcept
+    {
+        const size_type N = cholesky.shape().height;
+        const size_type M = rhs.size() / N;
+
+        const precision_type* a = cholesky.data();
+        precision_type* b = rhs.data();
+
+        // L . Y = B
+        for (size_type i = 0; i < N; ++i)
+        {
+            for (size_type k = 0; k < i; ++k)
+                axpy(b + i * M, b + i * M + M, -a[i * N + k], b + k * M);
+
+            const precision_type inverse_diagonal = precision_type(1) / a[i * N + i];
+            for (size_type j = 0; j < M; ++j) b[i * M + j] *= inverse_diagonal;
+        }
+
+        // L^T . X = Y
+        for (size_type i = N; i-- > 0;)
+        {
+            const precision_type inverse_diagonal = precision_type(1) / a[i * N + i];
+            for (size_type j = 0; j < M; ++j) b[i * M + j] *= inverse_diagonal;
+
+            for (size_type k = 0; k < i; ++k)
+                axpy(b + k * M, b + k * M + M, -a[i * N + k], b + i * M);
+        }
+    }
+
+    // Solve matrix . result = rhs by LU, matrix will be overwritten by the factorization,
+    // result MUST have the size of rhs. Return false if matrix is singular
+    template <class Result, class Matrix, class Rhs,
+              meta::as_iterate<Result> = 0,
+              meta::as_matrix<Matrix> = 0,
+              meta::as_iterate<Rhs> = 0>
+    bool solve(
+        Result& result,
+        Matrix& matrix,
+        const Rhs& rhs) const
+    {
+        std::vector<size_type> pivots(matrix.shape().height);
+        if (not lu(matrix, pivots.data())) return false;
+
+        result.copy(rhs.data());
+        lu_solve(matrix, pivots.data(), result);
+
+        return true;
+    }
+
+    // Solve matrix . result = rhs for the symmetric positive definite matrix by Cholesky,
+    // matrix will be overwritten by the factorization, result MUST have the size of rhs.
+    // Return false if matrix isn't positive definite
+    template <class Result, class Matrix, class Rhs,
+              meta::as_iterate<Result> = 0,
+              meta::as_matrix<Matrix> = 0,
+              meta::as_iterate<Rhs> = 0>
+    bool solve_spd(
+        Result& result,
+        Matrix& matrix,
+        const Rhs& rhs) const
+    {
+        if (not cholesky(matrix)) return false;
+
+        result.copy(rhs.data());
+        cholesky_solve(matrix, result);
+
+        return true;
+    }
+
     template <class Vector1, class Vector2,
               as_flat_iterate<Vector1> = 0,
               as_flat_iterate<Vector2> = 0>
@@ -441,6 +662,49 @@ public:
     {
         detail::for_each(first(tensor), last(tensor), func);
     }
+
+private:
+    static constexpr size_type factorization_block = 64;        ///< columns of the panel
+    static constexpr size_type factorization_per_thread = 1 << 16; ///< multiply-adds of the update
+
+    static void swap_rows(precision_type* lhs, precision_type* rhs, size_type size) noexcept
+    {
+        for (size_type j = 0; j < size; ++j)
+        {
+            const precision_type buff = lhs[j];
+            lhs[j] = rhs[j];
+            rhs[j] = buff;
+        }
+    }
+
+    // [first, last) += alpha * x
+    static void axpy(precision_type* first, precision_type* last, precision_type alpha, const precision_type* x) noexcept
+    {
+        for (; first != last; ++first, ++x) *first += alpha * (*x);
+    }
+
+    static precision_type inner(const precision_type* first, const precision_type* last, const precision_type* x) noexcept
+    {
+        precision_type result = 0.;
+        for (; first != last; ++first, ++x) result += (*first) * (*x);
+
+        return result;
+    }
+
+    // Split rows [0, rows) of the trailing update between threads by its work
+    template <class Function>
+    static void update(size_type rows, size_type work, Function function)
+    {
+        auto info = trixy::detail::parallel_info<factorization_per_thread>(work);
+
+        if (info.first > rows) info.first = rows;
+        info.second = rows / info.first;
+
+        trixy::detail::parallel_for(info, rows, [&function](size_type first, size_type last, size_type)
+        {
+            function(first, last);
+        });
+    }
 };
 
 } // namespace lique
@@ -205,9 +205,7 @@ public:
         if (this != &tensor)
         {
             this->data_ = tensor.data_;
-            this->shape_.height = tensor.shape_.height;
-            this->shape_.width = tensor.shape_.width;
-            this->shape_.size = tensor.shape_.size;
+            this->shape_ = tensor.shape_;
         }
 
         return *this;
@@ -218,9 +216,7 @@ public:
         if (this != &tensor)
         {
             this->data_ = tensor.data_;
-            this->shape_.height = tensor.shape_.height;
-            this->shape_.width = tensor.shape_.width;
-            this->shape_.size = tensor.shape_.size;
+            this->shape_ = tensor.shape_;
             tensor.data_ = nullptr;
         }
 
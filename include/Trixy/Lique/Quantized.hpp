@@ -0,0 +1,167 @@
+#ifndef TRIXY_LIQUE_QUANTIZED_HPP
+#define TRIXY_LIQUE_QUANTIZED_HPP
+
+#include <cmath> // fabs, lround
+#include <cstddef> // size_t
+#include <cstdint> // int8_t, uint8_t, int32_t
+#include <type_traits> // false_type, true_type
+#include <vector> // vector
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+#include <Trixy/Serializer/Core.hpp>
+
+#include <Trixy/Detail/TrixyMeta.hpp>
+
+namespace trixy
+{
+
+namespace lique
+{
+
+// Symmetric int8 quantization of the matrix rows, each row (output channel) has own scale:
+// row = scale * q, where q is in [-127, 127].
+// Input is quantized with single scale and zero point 128, so the products are uint8 x int8 -> int32,
+// and the zero point is removed by the precomputed row sums
+template <typename Precision>
+class QuantizedMatrix
+{
+    SERIALIZABLE_ACCESS()
+
+public:
+    using size_type      = std::size_t;
+    using precision_type = Precision;
+
+    static constexpr size_type alignment = 64;          ///< rows are padded by zeros up to the multiple of it
+    static constexpr std::int32_t zero_point = 128;
+    static constexpr std::int32_t limit = 127;
+
+private:
+    std::vector<std::int8_t> data_;
+    std::vector<precision_type> scale_;
+    std::vector<std::int32_t> sum_;
+
+    size_type height_;
+    size_type width_;
+    size_type stride_;
+
+public:
+    QuantizedMatrix() : height_(0), width_(0), stride_(0) {}
+
+    // Quantize height x width matrix, value(i, j) MUST return element j of the row i
+    template <class Value>
+    void quantize(size_type height, size_type width, Value value)
+    {
+        height_ = height;
+        width_ = width;
+        stride_ = (width + alignment - 1) / alignment * alignment;
+
+        data_.assign(height_ * stride_, 0);
+        scale_.assign(height_, precision_type(1.));
+        sum_.assign(height_, 0);
+
+        for (size_type i = 0; i < height_; ++i)
+        {
+            precision_type max = 0.;
+            for (size_type j = 0; j < width_; ++j)
+                if (std::fabs(value(i, j)) > max) max = std::fabs(value(i, j));
+
+            if (max > 0.) scale_[i] = max / limit;
+
+            const precision_type inverse = 1. / scale_[i];
+
+            std::int8_t* row = data_.data() + i * stride_;
+            for (size_type j = 0; j < width_; ++j)
+            {
+                row[j] = static_cast<std::int8_t>(clamp(std::lround(value(i, j) * inverse)));
+                sum_[i] += row[j];
+            }
+        }
+    }
+
+    size_type height() const noexcept { return height_; }
+    size_type width() const noexcept { return width_; }
+    size_type stride() const noexcept { return stride_; }
+
+    precision_type scale(size_type i) const noexcept { return scale_[i]; }
+    const std::int8_t* data() const noexcept { return data_.data(); }
+
+    // Quantize size values to the zero point form, the rest of [size, stride) is filled by zero point
+    void quantize(const precision_type* x, size_type size, precision_type inverse_scale, std::uint8_t* out) const noexcept
+    {
+        for (size_type j = 0; j < size; ++j)
+            out[j] = static_cast<std::uint8_t>(clamp(std::lround(x[j] * inverse_scale)) + zero_point);
+
+        for (size_type j = size; j < stride_; ++j) out[j] = zero_point;
+    }
+
+    // Product of the row i and quantized input of stride() size, the zero point is already removed
+    std::int32_t dot(size_type i, const std::uint8_t* x) const noexcept
+    {
+        const std::int8_t* row = data_.data() + i * stride_;
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+        // padding of rows is zero, so it doesn't affect the sum
+        __m512i accumulator = _mm512_setzero_si512();
+        for (size_type j = 0; j < stride_; j += alignment)
+        {
+            const __m512i lhs = _mm512_loadu_si512(reinterpret_cast<const void*>(x + j));
+            const __m512i rhs = _mm512_loadu_si512(reinterpret_cast<const void*>(row + j));
+
+            accumulator = _mm512_dpbusd_epi32(accumulator, lhs, rhs);
+        }
+
+        return _mm512_reduce_add_epi32(accumulator) - zero_point * sum_[i];
+#else
+        std::int32_t sum = 0;
+        for (size_type j = 0; j < width_; ++j)
+            sum += (static_cast<std::int32_t>(x[j]) - zero_point) * row[j];
+
+        return sum;
+#endif
+    }
+
+    // Per thread buffer for the quantized input
+    static std::uint8_t* buffer(size_type size)
+    {
+        static thread_local std::vector<std::uint8_t> storage;
+        if (storage.size() < size) storage.resize(size);
+
+        return storage.data();
+    }
+
+private:
+    static long clamp(long value) noexcept
+    {
+        const long bound = limit;
+        return value > bound ? bound : value < -bound ? -bound : value;
+    }
+};
+
+namespace meta
+{
+
+template <typename T> struct is_quantized_matrix : std::false_type {};
+template <typename Precision>
+struct is_quantized_matrix<QuantizedMatrix<Precision>> : std::true_type {};
+
+} // namespace meta
+
+} // namespace lique
+
+} // namespace trixy
+
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::lique::meta::is_quantized_matrix<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, matrix, trixy::lique::meta::is_quantized_matrix<S>::value)
+    SERIALIZATION
+    (
+        archive & matrix.height_ & matrix.width_ & matrix.stride_
+                & matrix.data_ & matrix.scale_ & matrix.sum_;
+    )
+SERIALIZABLE_INIT()
+
+#endif // TRIXY_LIQUE_QUANTIZED_HPP
@@ -0,0 +1,200 @@
+#ifndef TRIXY_LIQUE_REDUCED_HPP
+#define TRIXY_LIQUE_REDUCED_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint16_t
+#include <type_traits> // is_same
+#include <vector> // vector
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <Trixy/Base.hpp> // ComputeType
+
+#include <Trixy/Lique/Linear.hpp>
+#include <Trixy/Lique/Detail/LiqueMeta.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+
+namespace trixy
+{
+
+namespace lique
+{
+
+template <typename ComputeType>
+struct Reduced;
+
+template <> struct Reduced<ComputeType::BFloat16>
+{
+    static std::uint16_t encode(float value) noexcept { return trixy::detail::float_to_bfloat(value); }
+    static float decode(std::uint16_t value) noexcept { return trixy::detail::bfloat_to_float(value); }
+
+#if defined(__AVX512F__)
+    // 16 values to float: bfloat is the upper half of float
+    static __m512 decode(const std::uint16_t* src) noexcept
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(x), 16));
+    }
+#endif
+};
+
+template <> struct Reduced<ComputeType::Half>
+{
+    static std::uint16_t encode(float value) noexcept { return trixy::detail::float_to_half(value); }
+    static float decode(std::uint16_t value) noexcept { return trixy::detail::half_to_float(value); }
+
+#if defined(__AVX512F__)
+    static __m512 decode(const std::uint16_t* src) noexcept
+    {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+    }
+#endif
+};
+
+// Compute copy of the master matrix in reduced precision for the matrix-vector products.
+// Products are accumulated in the master precision, so only the matrix reading is halved.
+// Copy MUST be refreshed by copy() after each change of the master matrix
+template <typename Precision, typename ComputeType>
+class ReducedMatrix
+{
+public:
+    using size_type      = std::size_t;
+    using precision_type = Precision;
+
+    using codec          = Reduced<ComputeType>;
+
+private:
+    static constexpr size_type encode_per_thread = 1 << 16;
+
+    // intrinsics are used only for the float accumulation
+    static constexpr bool is_vectorized = std::is_same<Precision, float>::value;
+
+private:
+    std::vector<std::uint16_t> data_;
+
+    size_type height_;
+    size_type width_;
+
+public:
+    ReducedMatrix() : height_(0), width_(0) {}
+
+    template <class Matrix>
+    void copy(const Matrix& master)
+    {
+        height_ = master.shape().height;
+        width_ = master.shape().width;
+
+        data_.resize(height_ * width_);
+
+        const precision_type* src = master.data();
+        std::uint16_t* dst = data_.data();
+
+        auto info = trixy::detail::parallel_info<encode_per_thread>(data_.size());
+        trixy::detail::parallel_for(info, data_.size(), [src, dst](size_type first, size_type last, size_type)
+        {
+            for (size_type i = first; i < last; ++i) dst[i] = codec::encode(static_cast<float>(src[i]));
+        });
+    }
+
+    const std::uint16_t* data() const noexcept { return data_.data(); }
+    size_type size() const noexcept { return data_.size(); }
+
+    // result = row_vector . M, master is unused
+    template <class Vector1, class Vector2, class Matrix, meta::as_matrix<Matrix> = 0>
+    void dot(Vector1& result, const Vector2& row_vector, const Matrix& /*master*/) const noexcept
+    {
+        precision_type* out = result.data();
+        const precision_type* x = row_vector.data();
+
+        for (size_type j = 0; j < width_; ++j) out[j] = 0.;
+
+        for (size_type i = 0; i < height_; ++i)
+        {
+            const std::uint16_t* row = data_.data() + i * width_;
+            const precision_type temp = x[i];
+
+            size_type j = 0;
+#if defined(__AVX512F__)
+            if (is_vectorized)
+            {
+                const __m512 broadcast = _mm512_set1_ps(static_cast<float>(temp));
+                for (; j + 16 <= width_; j += 16)
+                {
+                    float* dst = reinterpret_cast<float*>(out + j);
+                    _mm512_storeu_ps(dst, _mm512_fmadd_ps(broadcast, codec::decode(row + j), _mm512_loadu_ps(dst)));
+                }
+            }
+#endif
+            for (; j < width_; ++j) out[j] += temp * codec::decode(row[j]);
+        }
+    }
+
+    // result = M . col_vector, master is unused
+    template <class Vector1, class Matrix, class Vector2, meta::as_matrix<Matrix> = 0>
+    void dot(Vector1& result, const Matrix& /*master*/, const Vector2& col_vector) const noexcept
+    {
+        precision_type* out = result.data();
+        const precision_type* x = col_vector.data();
+
+        for (size_type i = 0; i < height_; ++i)
+        {
+            const std::uint16_t* row = data_.data() + i * width_;
+            precision_type sum = 0.;
+
+            size_type j = 0;
+#if defined(__AVX512F__)
+            if (is_vectorized)
+            {
+                __m512 accumulator = _mm512_setzero_ps();
+                for (; j + 16 <= width_; j += 16)
+                {
+                    const float* src = reinterpret_cast<const float*>(x + j);
+                    accumulator = _mm512_fmadd_ps(codec::decode(row + j), _mm512_loadu_ps(src), accumulator);
+                }
+
+                sum = _mm512_reduce_add_ps(accumulator);
+            }
+#endif
+            for (; j < width_; ++j) sum += codec::decode(row[j]) * x[j];
+
+            out[i] = sum;
+        }
+    }
+};
+
+// Full precision compute, products are taken from the master matrix
+template <typename Precision>
+class ReducedMatrix<Precision, ComputeType::Native>
+{
+public:
+    using size_type      = std::size_t;
+    using precision_type = Precision;
+
+private:
+    Linear<Precision> linear;
+
+public:
+    template <class Matrix>
+    void copy(const Matrix&) noexcept { /*pass*/ }
+
+    template <class Vector1, class Vector2, class Matrix, meta::as_matrix<Matrix> = 0>
+    void dot(Vector1& result, const Vector2& row_vector, const Matrix& master) const noexcept
+    {
+        linear.dot(result, row_vector, master);
+    }
+
+    template <class Vector1, class Matrix, class Vector2, meta::as_matrix<Matrix> = 0>
+    void dot(Vector1& result, const Matrix& master, const Vector2& col_vector) const noexcept
+    {
+        linear.dot(result, master, col_vector);
+    }
+};
+
+} // namespace lique
+
+} // namespace trixy
+
+#endif // TRIXY_LIQUE_REDUCED_HPP
@@ -0,0 +1,143 @@
+#ifndef TRIXY_LIQUE_SPARSE_HPP
+#define TRIXY_LIQUE_SPARSE_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <type_traits> // false_type, true_type
+#include <vector> // vector
+
+#include <Trixy/Serializer/Core.hpp>
+
+namespace trixy
+{
+
+namespace lique
+{
+
+// Block compressed sparse rows with 4x1 blocks: each block keeps 4 consecutive rows of one column,
+// so the product makes 4 independent multiply-adds per stored column.
+// Block is stored if any of its values isn't zero, the last block row is padded by zero rows
+template <typename Precision>
+class SparseMatrix
+{
+    SERIALIZABLE_ACCESS()
+
+public:
+    using size_type      = std::size_t;
+    using precision_type = Precision;
+    using index_type     = std::uint32_t;
+
+    static constexpr size_type block = 4;
+
+private:
+    std::vector<index_type> offsets_;       ///< first block of each block row, block_rows + 1 values
+    std::vector<index_type> columns_;       ///< column of each block
+    std::vector<precision_type> values_;    ///< block values, block by block
+
+    size_type height_;
+    size_type width_;
+
+public:
+    SparseMatrix() : height_(0), width_(0) {}
+
+    // Compress height x width matrix, value(i, j) MUST return element j of the row i
+    template <class Value>
+    void compress(size_type height, size_type width, Value value)
+    {
+        height_ = height;
+        width_ = width;
+
+        const size_type block_rows = (height_ + block - 1) / block;
+
+        offsets_.assign(1, 0);
+        columns_.clear();
+        values_.clear();
+
+        precision_type buff[block];
+        for (size_type b = 0; b < block_rows; ++b)
+        {
+            for (size_type j = 0; j < width_; ++j)
+            {
+                bool is_zero = true;
+                for (size_type k = 0; k < block; ++k)
+                {
+                    const size_type i = b * block + k;
+
+                    buff[k] = i < height_ ? value(i, j) : precision_type(0.);
+                    is_zero = is_zero && buff[k] == 0.;
+                }
+
+                if (is_zero) continue;
+
+                columns_.push_back(static_cast<index_type>(j));
+                values_.insert(values_.end(), buff, buff + block);
+            }
+
+            offsets_.push_back(static_cast<index_type>(columns_.size()));
+        }
+    }
+
+    size_type height() const noexcept { return height_; }
+    size_type width() const noexcept { return width_; }
+
+    // Number of stored blocks
+    size_type blocks() const noexcept { return columns_.size(); }
+
+    // Fraction of the zero values, which are not stored
+    double sparsity() const noexcept
+    {
+        const double size = static_cast<double>(height_ * width_);
+        return size > 0. ? 1. - static_cast<double>(values_.size()) / size : 0.;
+    }
+
+    // result = M . col_vector, result MUST have height() size
+    void dot(precision_type* result, const precision_type* col_vector) const noexcept
+    {
+        const size_type block_rows = offsets_.size() - 1;
+
+        for (size_type b = 0; b < block_rows; ++b)
+        {
+            precision_type sum[block] = {};
+
+            const precision_type* values = values_.data() + block * offsets_[b];
+            for (index_type n = offsets_[b]; n < offsets_[b + 1]; ++n, values += block)
+            {
+                const precision_type x = col_vector[columns_[n]];
+                for (size_type k = 0; k < block; ++k) sum[k] += values[k] * x;
+            }
+
+            const size_type first = b * block;
+
+            size_type count = block;
+            if (height_ - first < count) count = height_ - first;
+
+            for (size_type k = 0; k < count; ++k) result[first + k] = sum[k];
+        }
+    }
+};
+
+namespace meta
+{
+
+template <typename T> struct is_sparse_matrix : std::false_type {};
+template <typename Precision>
+struct is_sparse_matrix<SparseMatrix<Precision>> : std::true_type {};
+
+} // namespace meta
+
+} // namespace lique
+
+} // namespace trixy
+
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::lique::meta::is_sparse_matrix<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, matrix, trixy::lique::meta::is_sparse_matrix<S>::value)
+    SERIALIZATION
+    (
+        archive & matrix.height_ & matrix.width_
+                & matrix.offsets_ & matrix.columns_ & matrix.values_;
+    )
+SERIALIZABLE_INIT()
+
+#endif // TRIXY_LIQUE_SPARSE_HPP
@@ -102,8 +102,8 @@ public:
             delete[] this->data_;
 
             this->data_ = new precision_type [tensor.shape_.size];
-            this->copy(tensor.data_);
             this->shape_ = tensor.shape_;
+            this->copy(tensor.data_);
         }
 
         return *this;
@@ -167,6 +167,13 @@ public:
 
         return *this;
     }
+
+    // Shape size MUST NOT be greater than the size of allocated memory
+    Tensor& reshape(const shape_type& shape) noexcept
+    {
+        this->shape_ = shape;
+        return *this;
+    }
 };
 
 template <typename Precision>
@@ -229,6 +236,13 @@ public:
 
         return *this;
     }
+
+    // Shape size MUST NOT be greater than the size of allocated memory
+    Tensor& reshape(const shape_type& shape) noexcept
+    {
+        this->shape_ = shape;
+        return *this;
+    }
 };
 
 } // namespace lique
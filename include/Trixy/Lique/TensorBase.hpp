@@ -41,6 +41,10 @@ using as_view_tensor_mode = trixy::meta::require<is_view_tensor_mode<T>::value>;
 template <typename T>
 using as_own_tensor_mode = trixy::meta::require<is_own_tensor_mode<T>::value>;
 
+template <typename> struct is_view_tensor : std::false_type {};
+template <typename Precision, typename TensorType>
+struct is_view_tensor<Tensor<Precision, TensorType, TensorMode::view>> : std::true_type {};
+
 } // namespace meta
 
 template <typename Precision>
@@ -312,7 +316,18 @@ CONDITIONAL_SERIALIZABLE(saveload, tensor, trixy::lique::meta::is_tensor_type<S>
     SERIALIZATION
     (
         archive & tensor.shape_;
-        archive & sf::span(tensor.data_, tensor.shape_.size);
+
+        auto scope = trixy::memory::MappingScope::current();
+
+        if (scope == nullptr)
+            archive & sf::span(tensor.data_, tensor.shape_.size);
+
+        else if (trixy::meta::is_oarchive(archive))
+            scope->save(tensor.data_, tensor.shape_.size);
+
+        else
+            scope->load(tensor.data_, tensor.shape_.size,
+                        trixy::lique::meta::is_view_tensor<trixy::meta::decay<decltype(tensor)>>());
     )
 SERIALIZABLE_INIT()
 
@@ -2,8 +2,10 @@
 #define TRIXY_LIQUE_TOOL_HPP
 
 #include <cstddef> // size_t
-#include <random> // rand
-#include <utility> // forward
+#include <functional> // ref, hash
+#include <thread> // this_thread
+#include <utility> // forward, pair
+#include <vector> // vector
 
 #include <Trixy/Lique/Vector.hpp>
 #include <Trixy/Lique/Matrix.hpp>
@@ -12,6 +14,9 @@
 #include <Trixy/Lique/Detail/FunctionDetail.hpp>
 
 #include <Trixy/Detail/TrixyMeta.hpp>
+#include <Trixy/Detail/FunctionDetail.hpp>
+
+#include <Trixy/Random/Core.hpp>
 
 #include <Trixy/Detail/MetaMacro.hpp>
 #include <Trixy/Detail/MacroScope.hpp>
@@ -30,13 +35,13 @@ namespace comp
 struct is_bigger
 {
     template <typename T>
-    bool operator() (T previous, T current) { return previous > current; }
+    bool operator() (T previous, T current) const { return previous > current; }
 };
 
 struct is_less
 {
     template <typename T>
-    bool operator() (T previous, T current) { return previous < current; }
+    bool operator() (T previous, T current) const { return previous < current; }
 };
 
 } // namespace comp
@@ -73,6 +78,57 @@ T accumulate(InIt first, InIt last, T init)
     return init;
 }
 
+namespace detail
+{
+
+// Minimal number of matrix elements per reduction thread
+constexpr std::size_t reduction_per_thread = 1 << 15;
+
+// Number of columns processed at once, so partial results of the tile stay in L1 cache
+constexpr std::size_t reduction_tile = 256;
+
+// Split rows of matrix between threads
+inline std::pair<std::size_t, std::size_t> reduction_info(std::size_t height, std::size_t width)
+{
+    auto info = trixy::detail::parallel_info<reduction_per_thread>(height * width);
+
+    if (info.first > height) info.first = height == 0 ? 1 : height;
+    info.second = height / info.first;
+
+    return info;
+}
+
+// Call function(row, first column, last column) for rows [first, last) tile by tile
+template <class Function>
+void for_each_tile(std::size_t first, std::size_t last, std::size_t width, Function function)
+{
+    for (std::size_t j0 = 0; j0 < width; j0 += reduction_tile)
+    {
+        const std::size_t j1 = j0 + reduction_tile < width ? j0 + reduction_tile : width;
+        for (std::size_t i = first; i < last; ++i) function(i, j0, j1);
+    }
+}
+
+// Merge Welford state (count, mean, sum of squared deviations) of two parts of data
+// by the Chan's formula, result will be stored in the first one
+inline void merge_moments(double count, double* mean, double* m2,
+                          double other_count, const double* other_mean, const double* other_m2,
+                          std::size_t size) noexcept
+{
+    const double total = count + other_count;
+    if (total == 0.) return;
+
+    for (std::size_t j = 0; j < size; ++j)
+    {
+        const double delta = other_mean[j] - mean[j];
+
+        mean[j] += delta * other_count / total;
+        m2[j] += other_m2[j] + delta * delta * count * other_count / total;
+    }
+}
+
+} // namespace detail
+
 template <class FwdIt, class Binary>
 FwdIt search(FwdIt first, FwdIt last, Binary compare) noexcept
 {
@@ -99,41 +155,77 @@ std::size_t search(const Iterable& it, Binary compare) noexcept
 }
 
 template <typename Precision, class Binary>
-Vector<std::size_t> search(const Matrix<Precision>& matrix, Axis axis, Binary compare) // repair
+Vector<std::size_t> search(const Matrix<Precision>& matrix, Axis axis, Binary compare)
 {
     using size_type = std::size_t;
 
-    const size_type block_size = matrix.shape().width;
-    const size_type number_of_blocks = matrix.shape().height;
-
-    Vector<size_type> vector;
-    size_type arg;
+    const size_type width = matrix.shape().width;
+    const size_type height = matrix.shape().height;
 
     if (axis == Axis::X)
     {
-        vector.resize(block_size);
-        vector.fill(size_type(0));
+        Vector<size_type> result(width, size_type(0));
+        if (height == 0) return result;
+
+        const auto info = detail::reduction_info(height, width);
+
+        std::vector<std::vector<size_type>> args(info.first, std::vector<size_type>(width));
+        std::vector<std::vector<Precision>> values(info.first, std::vector<Precision>(width));
+
+        trixy::detail::parallel_for(info, height,
+        [&matrix, &args, &values, width, compare](size_type first, size_type last, size_type thread) mutable
+        {
+            size_type* arg = args[thread].data();
+            Precision* value = values[thread].data();
+
+            detail::copy(value, value + width, matrix.data() + first * width);
+            for (size_type j = 0; j < width; ++j) arg[j] = first;
 
-        for (size_type i = 1; i < number_of_blocks; ++i)
-            for (size_type n = 0; n < vector.size(); ++n)
-                if (compare(matrix(vector(n), n), matrix(i, n)))
-                    vector(n) = i;
+            detail::for_each_tile(first + 1, last, width,
+            [&matrix, arg, value, width, &compare](size_type i, size_type j0, size_type j1)
+            {
+                const Precision* row = matrix.data() + i * width;
+                for (size_type j = j0; j < j1; ++j)
+                    if (compare(value[j], row[j]))
+                    {
+                        value[j] = row[j];
+                        arg[j] = i;
+                    }
+            });
+        });
+
+        // merge in the order of rows, so the first of equal elements wins as in sequential search
+        for (size_type t = 1; t < info.first; ++t)
+            for (size_type j = 0; j < width; ++j)
+                if (compare(values[0][j], values[t][j]))
+                {
+                    values[0][j] = values[t][j];
+                    args[0][j] = args[t][j];
+                }
+
+        detail::copy(result.data(), result.data() + width, args[0].data());
+
+        return result;
     }
     else if (axis == Axis::Y)
     {
-        vector.resize(number_of_blocks);
+        Vector<size_type> result(height, size_type(0));
+        if (width == 0) return result;
 
-        for (size_type n = 0; n < vector.size(); ++n)
+        trixy::detail::parallel_for(detail::reduction_info(height, width), height,
+        [&matrix, &result, width, compare](size_type first, size_type last, size_type /*thread*/) mutable
         {
-            for (size_type i = 1; i < block_size; ++i)
-                if (compare(matrix(n, arg), matrix(n, i)))
-                    arg = i;
+            for (size_type i = first; i < last; ++i)
+            {
+                const Precision* row = matrix.data() + i * width;
+                result(i) = lique::search(row, row + width, compare) - row;
+            }
+        });
 
-            vector(n) = arg;
-        }
+        return result;
     }
 
-    return vector;
+    return Vector<size_type>();
 }
 
 template <class FwdIt>
@@ -241,118 +333,174 @@ T std(const Iterable& it, bool unbiased = false)
 }
 
 TRIXY_FUNCTION_TEMPLATE()
-Vector<double> mean(const Matrix<Precision>& matrix, Axis axis) // repair
+Vector<double> sum(const Matrix<Precision>& matrix, Axis axis)
 {
-    using size_type = typename Matrix<Precision>::size_type;
-
-    const size_type block_size = matrix.shape().width;
-    const size_type number_of_blocks = matrix.shape().height;
-
-    auto m_first = first(matrix);
-    auto m_last  = last(matrix);
+    using size_type = std::size_t;
 
-    Vector<double> vector;
+    const size_type width = matrix.shape().width;
+    const size_type height = matrix.shape().height;
 
     if (axis == Axis::X)
     {
-        vector.resize(block_size, Precision(0.));
+        Vector<double> result(width, 0.);
+        if (height == 0) return result;
+
+        const auto info = detail::reduction_info(height, width);
 
-        auto v_first = first(vector);
-        auto v_last = last(vector);
+        std::vector<std::vector<double>> partials(info.first, std::vector<double>(width, 0.));
 
-        while (m_first != m_last)
+        trixy::detail::parallel_for(info, height,
+        [&matrix, &partials, width](size_type first, size_type last, size_type thread)
         {
-            detail::assign(v_first, v_last, detail::add(), m_first);
-            m_first += vector.size();
-        }
+            double* partial = partials[thread].data();
+
+            detail::for_each_tile(first, last, width,
+            [&matrix, partial, width](size_type i, size_type j0, size_type j1)
+            {
+                const Precision* row = matrix.data() + i * width;
+                for (size_type j = j0; j < j1; ++j) partial[j] += row[j];
+            });
+        });
 
-        vector.join( 1. / static_cast<double>(number_of_blocks));
+        for (const auto& partial : partials)
+            for (size_type j = 0; j < width; ++j) result(j) += partial[j];
+
+        return result;
     }
     else if (axis == Axis::Y)
     {
-        vector.resize(number_of_blocks);
-
-        auto v_first = first(vector);
-        auto v_last = last(vector);
+        Vector<double> result(height, 0.);
 
-        while (v_first != v_last)
+        trixy::detail::parallel_for(detail::reduction_info(height, width), height,
+        [&matrix, &result, width](size_type first, size_type last, size_type /*thread*/)
         {
-            *v_first = lique::accumulate(m_first, m_first + block_size, Precision(0.));
-
-            m_first += block_size;
-            ++v_first;
-        }
+            for (size_type i = first; i < last; ++i)
+            {
+                const Precision* row = matrix.data() + i * width;
+                result(i) = lique::accumulate(row, row + width, 0.);
+            }
+        });
 
-        vector.join(1. / static_cast<double>(block_size));
+        return result;
     }
 
-    return vector;
+    return Vector<double>();
 }
 
 TRIXY_FUNCTION_TEMPLATE()
-Vector<double> std(const Matrix<Precision>& matrix, Axis axis, bool unbiased = false)
+Vector<double> mean(const Matrix<Precision>& matrix, Axis axis)
 {
-    using size_type = typename Matrix<Precision>::size_type;
-
-    const size_type block_size = matrix.shape().width;
-    const size_type number_of_blocks = matrix.shape().height;
+    Vector<double> result = sum(matrix, axis);
 
-    Vector<double> vector = mean(matrix, axis);
+    const std::size_t count = axis == Axis::X ? matrix.shape().height : matrix.shape().width;
+    if (count > 0) result.join(1. / static_cast<double>(count));
 
-    double std_value;
-    double mean_value;
+    return result;
+}
 
-    double buff;
+// Single pass (Welford) mean and variance along the axis,
+// partial results of the row chunks are merged by the Chan's formula
+TRIXY_FUNCTION_TEMPLATE()
+void moments(const Matrix<Precision>& matrix, Axis axis,
+             Vector<double>& mean, Vector<double>& variance, bool unbiased = false)
+{
+    using size_type = std::size_t;
 
-    auto accumulate_std = [buff](double mean, double value, double& accumulate) mutable
-    {
-        buff = mean - value;
-        accumulate += buff * buff;
-    };
+    const size_type width = matrix.shape().width;
+    const size_type height = matrix.shape().height;
 
     if (axis == Axis::X)
     {
-        for (size_type i = 0; i < vector.size(); ++i)
+        mean = Vector<double>(width, 0.);
+        variance = Vector<double>(width, 0.);
+
+        if (height == 0) return;
+
+        const auto info = detail::reduction_info(height, width);
+
+        std::vector<std::vector<double>> means(info.first, std::vector<double>(width, 0.));
+        std::vector<std::vector<double>> squares(info.first, std::vector<double>(width, 0.));
+
+        trixy::detail::parallel_for(info, height,
+        [&matrix, &means, &squares, width](size_type first, size_type last, size_type thread)
         {
-            std_value = 0.;
-            for (size_type n = 0; n < number_of_blocks; ++n)
-                accumulate_std(vector(i), matrix(n, i), std_value);
+            double* m = means[thread].data();
+            double* m2 = squares[thread].data();
 
-            vector(i) = std_value;
+            detail::for_each_tile(first, last, width,
+            [&matrix, m, m2, first, width](size_type i, size_type j0, size_type j1)
+            {
+                const Precision* row = matrix.data() + i * width;
+                const double inverse_count = 1. / static_cast<double>(i - first + 1);
+
+                for (size_type j = j0; j < j1; ++j)
+                {
+                    const double delta = row[j] - m[j];
+                    m[j] += delta * inverse_count;
+                    m2[j] += delta * (row[j] - m[j]);
+                }
+            });
+        });
+
+        double count = static_cast<double>(info.second);
+        for (size_type t = 1; t < info.first; ++t)
+        {
+            const double chunk = static_cast<double>(t + 1 < info.first ? info.second : height - t * info.second);
+
+            detail::merge_moments(count, means[0].data(), squares[0].data(),
+                                  chunk, means[t].data(), squares[t].data(), width);
+            count += chunk;
         }
 
-        vector.join(1. / static_cast<double>(number_of_blocks - unbiased));
-        vector.apply<double (*)(double)>(std::sqrt);
+        detail::copy(mean.data(), mean.data() + width, means[0].data());
+        detail::copy(variance.data(), variance.data() + width, squares[0].data());
+
+        if (height > static_cast<size_type>(unbiased))
+            variance.join(1. / static_cast<double>(height - unbiased));
     }
-    else
+    else if (axis == Axis::Y)
     {
-        auto v_first = first(vector);
-        auto v_last  = last(vector);
+        mean = Vector<double>(height, 0.);
+        variance = Vector<double>(height, 0.);
 
-        auto m_first = first(matrix);
+        if (width == 0) return;
 
-        while (v_first != v_last)
-        {
-            std_value = 0.;
+        const double scale = width > static_cast<size_type>(unbiased) ? 1. / static_cast<double>(width - unbiased) : 0.;
 
-            mean_value = *v_first;
-            auto accumulate_adapter = [accumulate_std, mean_value, &std_value](double value)
+        trixy::detail::parallel_for(detail::reduction_info(height, width), height,
+        [&matrix, &mean, &variance, width, scale](size_type first, size_type last, size_type /*thread*/)
+        {
+            for (size_type i = first; i < last; ++i)
             {
-                accumulate_std(mean_value, value, std_value);
-            };
-
-            detail::for_each(m_first, m_first + block_size, accumulate_adapter);
-            *v_first = std_value;
+                const Precision* row = matrix.data() + i * width;
+
+                double m = 0.;
+                double m2 = 0.;
+
+                for (size_type j = 0; j < width; ++j)
+                {
+                    const double delta = row[j] - m;
+                    m += delta / static_cast<double>(j + 1);
+                    m2 += delta * (row[j] - m);
+                }
+
+                mean(i) = m;
+                variance(i) = m2 * scale;
+            }
+        });
+    }
+}
 
-            m_first += block_size;
-            ++v_first;
-        }
+TRIXY_FUNCTION_TEMPLATE()
+Vector<double> std(const Matrix<Precision>& matrix, Axis axis, bool unbiased = false)
+{
+    Vector<double> mean;
+    Vector<double> variance;
 
-        vector.join(1. / static_cast<double>(block_size - unbiased));
-        vector.apply<double (*)(double)>(std::sqrt);
-    }
+    moments(matrix, axis, mean, variance, unbiased);
+    variance.apply<double (*)(double)>(std::sqrt);
 
-    return vector;
+    return variance;
 }
 
 using detail::for_each;
@@ -465,16 +613,30 @@ std::size_t multinomial(const Iterable& it, Generator generator, std::size_t ran
     return multinomial(first(it), last(it), generator, rand_max);
 }
 
+namespace detail
+{
+
+// Own generator for each thread, no shared state
+inline utility::DefaultGenerator& default_generator() noexcept
+{
+    static thread_local utility::DefaultGenerator generator(
+        utility::DefaultGenerator::seed() ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    return generator;
+}
+
+} // namespace detail
+
 template <class FwdIt>
 std::size_t multinomial(FwdIt first, FwdIt last) noexcept
 {
-    return multinomial(first, last, std::rand, RAND_MAX);
+    return multinomial(first, last, std::ref(detail::default_generator()), utility::DefaultGenerator::max());
 }
 
 template <class Iterable, lique::meta::as_iterate<Iterable> = 0>
 std::size_t multinomial(const Iterable& it) noexcept
 {
-    return multinomial(it, std::rand, RAND_MAX);
+    return multinomial(it, std::ref(detail::default_generator()), utility::DefaultGenerator::max());
 }
 
 } // namespace lique
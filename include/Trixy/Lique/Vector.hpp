@@ -92,6 +92,7 @@ public:
     }
 
     Tensor(const Tensor& tensor)
+        : Base(tensor.shape_.width)
     {
         this->data_ = new precision_type [tensor.shape_.size];
         this->copy(tensor.data_);
@@ -189,8 +190,7 @@ public:
         if (this != &tensor)
         {
             this->data_ = tensor.data_;
-            this->shape_.width = tensor.shape_.width;
-            this->shape_.size = tensor.shape_.size;
+            this->shape_ = tensor.shape_;
         }
 
         return *this;
@@ -201,8 +201,7 @@ public:
         if (this != &tensor)
         {
             this->data_ = tensor.data_;
-            this->shape_.width = tensor.shape_.width;
-            this->shape_.size = tensor.shape_.size;
+            this->shape_ = tensor.shape_;
             tensor.data_ = nullptr;
         }
 
@@ -32,13 +32,13 @@ public:
 
     TRIXY_ACCURACY_TEMPLATE()
     double normal(const Container<Sample>& idata,
-                       const Container<Target>& odata) noexcept
+                       const Container<Target>& odata)
     {
-        size_type count = 0;
-
-        for (size_type i = 0; i < odata.size(); ++i)
-            if (Guide::normal(odata[i], net.feedforward(idata[i])))
-                ++count;
+        size_type count = net.evaluate(idata, size_type(0), [&odata]
+        (size_type& count, size_type i, const Sample& prediction)
+        {
+            if (Guide::normal(odata[i], prediction)) ++count;
+        });
 
         return static_cast<double>(count) / odata.size();
     }
@@ -46,13 +46,13 @@ public:
     TRIXY_ACCURACY_TEMPLATE()
     double full(const Container<Sample>& idata,
                      const Container<Target>& odata,
-                     precision_type range_rate) noexcept
+                     precision_type range_rate)
     {
-        size_type count = 0;
-
-        for (size_type i = 0; i < odata.size(); ++i)
-            if (Guide::full(odata[i], net.feedforward(idata[i]), range_rate))
-                ++count;
+        size_type count = net.evaluate(idata, size_type(0), [&odata, range_rate]
+        (size_type& count, size_type i, const Sample& prediction)
+        {
+            if (Guide::full(odata[i], prediction, range_rate)) ++count;
+        });
 
         return static_cast<double>(count) / odata.size();
     }
@@ -60,19 +60,20 @@ public:
     TRIXY_ACCURACY_TEMPLATE()
     double global(const Container<Sample>& idata,
                        const Container<Target>& odata,
-                       precision_type range_rate) noexcept
+                       precision_type range_rate)
     {
-        size_type count = 0;
-
-        for (size_type i = 0; i < odata.size(); ++i)
-            count += Guide::global(odata[i], net.feedforward(idata[i]), range_rate);
+        size_type count = net.evaluate(idata, size_type(0), [&odata, range_rate]
+        (size_type& count, size_type i, const Sample& prediction)
+        {
+            count += Guide::global(odata[i], prediction, range_rate);
+        });
 
         return static_cast<double>(count) / (odata.size() * odata.front().size());
     }
 
     TRIXY_ACCURACY_TEMPLATE()
     double operator() (const Container<Sample>& idata,
-                            const Container<Target>& odata) noexcept
+                            const Container<Target>& odata)
     {
         return normal(idata, odata);
     }
@@ -2,6 +2,9 @@
 #define TRIXY_NEURO_CHECKER_HPP
 
 #include <Trixy/Neuro/Checker/Accuracy.hpp>
+#include <Trixy/Neuro/Checker/Metrics.hpp>
+
+#include <Trixy/Detail/TrixyMeta.hpp>
 
 namespace trixy
 {
@@ -38,20 +41,53 @@ public:
               class Sample, class Target, class LossFunction>
     double loss(const Container<Sample>& idata,
                      const Container<Target>& odata,
-                     LossFunction loss_function) noexcept
+                     LossFunction loss_function)
     {
-        precision_type result = 0.;
-        precision_type error  = 0.;
-
-        for (size_type i = 0; i < odata.size(); ++i)
+        // each evaluation thread takes own copy of the loss function
+        double result = net.evaluate(idata, 0., [&odata, loss_function]
+        (double& result, size_type i, const Sample& prediction) mutable
         {
-            loss_function(error, odata[i], net.feedforward(idata[i]));
+            precision_type error = 0.;
+
+            loss_function(error, odata[i], prediction);
             result += error;
-        }
+        });
 
         return result / static_cast<double>(odata.size());
     }
 
+    // Collect all metrics over the dataset in a single parallel sweep
+    template <template <typename, typename...> class Container,
+              class Sample, class Target>
+    Metrics<Net> metrics(const Container<Sample>& idata,
+                         const Container<Target>& odata,
+                         size_type top_k = 1)
+    {
+        return net.evaluate(idata, Metrics<Net>(odata.front().size(), top_k), [&odata]
+        (Metrics<Net>& metrics, size_type i, const Sample& prediction)
+        {
+            metrics.update(odata[i], prediction);
+        });
+    }
+
+    template <template <typename, typename...> class Container,
+              class Sample, class Target, class LossFunction,
+              meta::require<not std::is_arithmetic<LossFunction>::value> = 0>
+    Metrics<Net> metrics(const Container<Sample>& idata,
+                         const Container<Target>& odata,
+                         LossFunction loss_function,
+                         size_type top_k = 1)
+    {
+        return net.evaluate(idata, Metrics<Net>(odata.front().size(), top_k), [&odata, loss_function]
+        (Metrics<Net>& metrics, size_type i, const Sample& prediction) mutable
+        {
+            precision_type error = 0.;
+
+            loss_function(error, odata[i], prediction);
+            metrics.update(odata[i], prediction, error);
+        });
+    }
+
     template <class Sample, class Target, class LossFunction>
     double loss(const Sample& sample,
                      const Target& target,
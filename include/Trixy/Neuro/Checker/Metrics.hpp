@@ -0,0 +1,181 @@
+#ifndef TRIXY_NEURO_CHECKER_METRICS_HPP
+#define TRIXY_NEURO_CHECKER_METRICS_HPP
+
+#include <Trixy/Neuro/Checker/Detail/MacroScope.hpp>
+
+namespace trixy
+{
+
+// Single pass classification metrics accumulator:
+// confusion matrix, top-k hits, per class precision/recall and mean loss.
+// Accumulators from different threads can be merged with operator+=
+template <class Checkable>
+class Metrics
+{
+public:
+    using Net = Checkable;
+
+    template <typename T>
+    using Container             = typename Net::template Container<T>;
+
+    using precision_type        = typename Net::precision_type;
+    using size_type             = typename Net::size_type;
+
+private:
+    size_type classes_;
+    size_type top_k_;
+
+    Container<size_type> confusion_;    ///< [true class][predicted class]
+
+    size_type count_;
+    size_type top_k_hits_;
+
+    double loss_;
+
+public:
+    explicit Metrics(size_type classes, size_type top_k = 1)
+        : classes_(classes), top_k_(top_k)
+        , confusion_(classes * classes)
+        , count_(0), top_k_hits_(0), loss_(0.)
+    {
+    }
+
+    TRIXY_ACCURACY_GUIDE_TEMPLATE()
+    void update(const Target& target, const Prediction& prediction) noexcept
+    {
+        record(target.data(), prediction.data());
+    }
+
+    TRIXY_ACCURACY_GUIDE_TEMPLATE()
+    void update(const Target& target, const Prediction& prediction, precision_type loss) noexcept
+    {
+        record(target.data(), prediction.data());
+        loss_ += loss;
+    }
+
+    // Targets and predictions are stored row by row with 'classes' elements per row
+    TRIXY_ACCURACY_GUIDE_TEMPLATE()
+    void update_batch(const Target& targets, const Prediction& predictions) noexcept
+    {
+        if (classes_ == 0) return;
+
+        const size_type batch_size = predictions.size() / classes_;
+
+        auto target = targets.data();
+        auto prediction = predictions.data();
+
+        for (size_type i = 0; i < batch_size; ++i)
+        {
+            record(target, prediction);
+
+            target += classes_;
+            prediction += classes_;
+        }
+    }
+
+    Metrics& operator+= (const Metrics& metrics) noexcept
+    {
+        for (size_type i = 0; i < confusion_.size(); ++i)
+            confusion_[i] += metrics.confusion_[i];
+
+        count_ += metrics.count_;
+        top_k_hits_ += metrics.top_k_hits_;
+        loss_ += metrics.loss_;
+
+        return *this;
+    }
+
+    Metrics& merge(const Metrics& metrics) noexcept { return *this += metrics; }
+
+    void reset() noexcept
+    {
+        for (auto& value : confusion_) value = 0;
+
+        count_ = 0;
+        top_k_hits_ = 0;
+        loss_ = 0.;
+    }
+
+    size_type classes() const noexcept { return classes_; }
+    size_type top_k() const noexcept { return top_k_; }
+    size_type count() const noexcept { return count_; }
+
+    size_type confusion(size_type true_class, size_type predicted_class) const noexcept
+    {
+        return confusion_[true_class * classes_ + predicted_class];
+    }
+
+    double accuracy() const noexcept
+    {
+        size_type hits = 0;
+        for (size_type c = 0; c < classes_; ++c) hits += confusion(c, c);
+
+        return ratio(hits, count_);
+    }
+
+    double top_k_accuracy() const noexcept { return ratio(top_k_hits_, count_); }
+
+    double precision(size_type c) const noexcept
+    {
+        size_type predicted = 0;
+        for (size_type i = 0; i < classes_; ++i) predicted += confusion(i, c);
+
+        return ratio(confusion(c, c), predicted);
+    }
+
+    double recall(size_type c) const noexcept
+    {
+        size_type actual = 0;
+        for (size_type j = 0; j < classes_; ++j) actual += confusion(c, j);
+
+        return ratio(confusion(c, c), actual);
+    }
+
+    double f1(size_type c) const noexcept
+    {
+        const double p = precision(c);
+        const double r = recall(c);
+
+        return p + r > 0. ? 2. * p * r / (p + r) : 0.;
+    }
+
+    double loss() const noexcept { return count_ == 0 ? 0. : loss_ / count_; }
+
+private:
+    static double ratio(size_type numerator, size_type denominator) noexcept
+    {
+        return denominator == 0 ? 0. : static_cast<double>(numerator) / denominator;
+    }
+
+    template <typename Pointer>
+    size_type argmax(Pointer data) const noexcept
+    {
+        size_type max = 0;
+        for (size_type j = 1; j < classes_; ++j)
+            if (data[max] < data[j]) max = j;
+
+        return max;
+    }
+
+    template <typename TargetPointer, typename PredictionPointer>
+    void record(TargetPointer target, PredictionPointer prediction) noexcept
+    {
+        const size_type true_class = argmax(target);
+        const size_type predicted_class = argmax(prediction);
+
+        ++confusion_[true_class * classes_ + predicted_class];
+
+        // rank of the true class is the number of strictly better scores
+        size_type rank = 0;
+        for (size_type j = 0; j < classes_; ++j)
+            if (prediction[true_class] < prediction[j]) ++rank;
+
+        if (rank < top_k_) ++top_k_hits_;
+
+        ++count_;
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_NEURO_CHECKER_METRICS_HPP
@@ -10,11 +10,15 @@
 
 #include <Trixy/Neuro/Checker/Core.hpp>
 
+#include <Trixy/Neuro/Dataset/Core.hpp>
+
 #include <Trixy/Neuro/Functional/Function/Core.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Core.hpp>
 
 #include <Trixy/Neuro/Functional/Core.hpp>
 
 #include <Trixy/Neuro/Serializer/Core.hpp>
+#include <Trixy/Neuro/Serializer/Mapped.hpp>
+#include <Trixy/Neuro/Serializer/Checkpoint.hpp>
 
 #endif // TRIXY_NEURO_CORE_HPP
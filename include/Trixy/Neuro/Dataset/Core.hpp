@@ -0,0 +1,10 @@
+#ifndef TRIXY_DATASET_CORE_HPP
+#define TRIXY_DATASET_CORE_HPP
+
+#include <Trixy/Neuro/Dataset/Normalizer.hpp>
+#include <Trixy/Neuro/Dataset/Idx.hpp>
+#include <Trixy/Neuro/Dataset/Dataset.hpp>
+#include <Trixy/Neuro/Dataset/Source.hpp>
+#include <Trixy/Neuro/Dataset/Loader.hpp>
+
+#endif // TRIXY_DATASET_CORE_HPP
@@ -0,0 +1,228 @@
+#ifndef TRIXY_DATASET_DATASET_HPP
+#define TRIXY_DATASET_DATASET_HPP
+
+#include <cmath> // floor
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t
+#include <vector> // vector
+
+#include <Trixy/Neuro/Dataset/Idx.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+
+namespace trixy
+{
+
+namespace data
+{
+
+enum class DataType { uint8, float16, bfloat16 };
+
+// Compact storage of the samples: each element is kept as uint8, IEEE half or bfloat16
+// of (x - offset) / scale, and it's dequantized to the precision type only when
+// the batch is gathered. For example, MNIST takes 47 MB as uint8 instead of 188 MB as float.
+// All samples have the same shape, which is defined by the first pushed sample
+template <class TypeSet>
+class Dataset
+{
+public:
+    template <typename T>
+    using Container             = typename TypeSet::template Container<T>;
+
+    using Tensor                = typename TypeSet::Tensor;
+
+    using precision_type        = typename TypeSet::precision_type;
+    using size_type             = typename TypeSet::size_type;
+    using shape_type            = typename Tensor::shape_type;
+
+private:
+    DataType type_;
+
+    shape_type shape_;              ///< shape of each sample
+    size_type size_;
+
+    std::vector<std::uint8_t> bytes_;   ///< uint8 storage
+    std::vector<std::uint16_t> words_;  ///< float16 and bfloat16 storage
+
+    double scale_;
+    double offset_;
+
+public:
+    explicit Dataset(DataType type = DataType::uint8, double scale = 1., double offset = 0.)
+        : type_(type), shape_(), size_(0), bytes_(), words_()
+        , scale_(scale != 0. ? scale : 1.), offset_(offset)
+    {
+    }
+
+    // Quantize samples, uint8 type takes the range of samples as [offset, offset + 255 * scale]
+    Dataset(const Container<Tensor>& samples, DataType type)
+        : Dataset(type)
+    {
+        if (samples.size() == 0) return;
+
+        if (type == DataType::uint8)
+        {
+            double min = samples[0](0);
+            double max = min;
+
+            for (const auto& sample : samples)
+                for (size_type j = 0; j < sample.size(); ++j)
+                {
+                    if (sample(j) < min) min = sample(j);
+                    if (sample(j) > max) max = sample(j);
+                }
+
+            offset_ = min;
+            scale_ = max > min ? (max - min) / 255. : 1.;
+        }
+
+        reserve(samples.size(), samples[0].size());
+        for (const auto& sample : samples) push(sample);
+    }
+
+    // Copy bytes of the IDX file as is, labels are stored as one hot vectors
+    explicit Dataset(const IdxFile& file)
+        : Dataset(DataType::uint8, file.classes() > 0 ? 1. : file.scale(), file.classes() > 0 ? 0. : file.offset())
+    {
+        if (not file.is_open()) return;
+
+        shape_ = shape_type(1, 1, file.features());
+        size_ = file.size();
+
+        if (file.classes() > 0)
+        {
+            bytes_.assign(size_ * file.classes(), 0);
+
+            for (size_type i = 0; i < size_; ++i)
+                if (*file.sample(i) < file.classes()) bytes_[i * file.classes() + *file.sample(i)] = 1;
+        }
+        else bytes_.assign(file.data(), file.data() + size_ * file.sample_size());
+    }
+
+    void reserve(size_type size, size_type features)
+    {
+        if (type_ == DataType::uint8) bytes_.reserve(size * features);
+        else words_.reserve(size * features);
+    }
+
+    void push(const Tensor& sample)
+    {
+        if (size_ == 0) shape_ = sample.shape();
+
+        const double inverse_scale = 1. / scale_;
+
+        for (size_type j = 0; j < shape_.size; ++j)
+        {
+            const double value = (sample(j) - offset_) * inverse_scale;
+
+            switch (type_)
+            {
+            case DataType::uint8:
+                bytes_.push_back(static_cast<std::uint8_t>(
+                    value <= 0. ? 0. : value >= 255. ? 255. : std::floor(value + 0.5)));
+                break;
+
+            case DataType::float16:
+                words_.push_back(trixy::detail::float_to_half(static_cast<float>(value)));
+                break;
+
+            case DataType::bfloat16:
+                words_.push_back(trixy::detail::float_to_bfloat(static_cast<float>(value)));
+                break;
+            }
+        }
+
+        ++size_;
+    }
+
+    DataType type() const noexcept { return type_; }
+
+    size_type size() const noexcept { return size_; }
+    size_type features() const noexcept { return shape_.size; }
+
+    const shape_type& shape() const noexcept { return shape_; }
+
+    double scale() const noexcept { return scale_; }
+    double offset() const noexcept { return offset_; }
+
+    // Size of the storage in bytes
+    size_type bytes() const noexcept
+    {
+        return bytes_.size() * sizeof(std::uint8_t) + words_.size() * sizeof(std::uint16_t);
+    }
+
+    // Dequantize sample to the tensor, it will be resized only if it has another size
+    template <class Sample>
+    void load(size_type i, Sample& tensor) const
+    {
+        if (tensor.size() != shape_.size) tensor.resize(shape_);
+
+        decode(i, tensor.data());
+    }
+
+    // Dequantize samples by indices to the reusable batch of tensors
+    template <class Batch>
+    void gather(const size_type* indices, size_type count, Batch& batch) const
+    {
+        if (batch.size() != count) batch.resize(count);
+
+        for (size_type k = 0; k < count; ++k) load(indices[k], batch[k]);
+    }
+
+    // Dequantize samples [first, first + count) to the reusable batch of tensors
+    template <class Batch>
+    void load(size_type first, size_type count, Batch& batch) const
+    {
+        if (batch.size() != count) batch.resize(count);
+
+        for (size_type k = 0; k < count; ++k) load(first + k, batch[k]);
+    }
+
+    // Write dequantized sample to the 'features()' elements from out
+    void decode(size_type i, precision_type* out) const noexcept
+    {
+        const precision_type scale = static_cast<precision_type>(scale_);
+        const precision_type offset = static_cast<precision_type>(offset_);
+
+        const size_type features = shape_.size;
+
+        if (type_ == DataType::uint8)
+        {
+            const std::uint8_t* sample = bytes_.data() + i * features;
+
+            for (size_type j = 0; j < features; ++j)
+                out[j] = static_cast<precision_type>(sample[j]) * scale + offset;
+
+            return;
+        }
+
+        const std::uint16_t* sample = words_.data() + i * features;
+
+        if (type_ == DataType::float16)
+        {
+            for (size_type j = 0; j < features; ++j)
+                out[j] = static_cast<precision_type>(trixy::detail::half_to_float(sample[j])) * scale + offset;
+        }
+        else
+        {
+            for (size_type j = 0; j < features; ++j)
+                out[j] = static_cast<precision_type>(trixy::detail::bfloat_to_float(sample[j])) * scale + offset;
+        }
+    }
+};
+
+// Stream dequantized samples to the Normalizer
+template <class TypeSet, class Matrix>
+void rows(const Dataset<TypeSet>& source, std::size_t first, std::size_t count, Matrix& matrix) noexcept
+{
+    auto row = matrix.data();
+
+    for (std::size_t i = first; i < first + count; ++i, row += source.features())
+        source.decode(i, row);
+}
+
+} // namespace data
+
+} // namespace trixy
+
+#endif // TRIXY_DATASET_DATASET_HPP
@@ -0,0 +1,185 @@
+#ifndef TRIXY_DATASET_IDX_HPP
+#define TRIXY_DATASET_IDX_HPP
+
+#include <cstddef> // size_t
+#include <memory> // shared_ptr, make_shared
+#include <type_traits> // remove_reference
+#include <vector> // vector
+
+#include <Trixy/Serializer/Mapping.hpp>
+
+namespace trixy
+{
+
+namespace data
+{
+
+// Zero-copy reader of the IDX files with unsigned byte data (MNIST format):
+// [0x00 0x00 0x08 number of dimensions][big endian uint32 dimensions][data].
+// The first dimension is a number of samples, samples are views to the mapped file
+// and they are converted to the precision type only when a batch is gathered.
+// Copies of the reader share the same mapping
+class IdxFile
+{
+public:
+    using byte_type = unsigned char;
+    using size_type = std::size_t;
+
+private:
+    std::shared_ptr<memory::MappedFile> file_;
+
+    std::vector<size_type> dims_;
+
+    const byte_type* data_;
+
+    size_type size_;
+    size_type sample_size_;
+
+    double scale_;
+    double offset_;
+
+    size_type classes_;     ///< if not zero, samples are labels which will be one hot encoded
+
+public:
+    explicit IdxFile(const char* path)
+        : file_(std::make_shared<memory::MappedFile>(path)), dims_(), data_(nullptr)
+        , size_(0), sample_size_(0), scale_(1.), offset_(0.), classes_(0)
+    {
+        if (not file_->is_open() || file_->size() < 4) return;
+
+        const byte_type* header = file_->data();
+
+        // only unsigned byte data is supported
+        if (header[0] != 0 || header[1] != 0 || header[2] != 0x08 || header[3] == 0) return;
+
+        const size_type number_of_dims = header[3];
+        const size_type data_offset = 4 + 4 * number_of_dims;
+
+        if (file_->size() < data_offset) return;
+
+        dims_.resize(number_of_dims);
+
+        // dimensions are checked against the data length before each multiply, so crafted header can't overflow
+        const size_type length = file_->size() - data_offset;
+
+        size_type sample_size = 1;
+        for (size_type i = 0; i < number_of_dims; ++i)
+        {
+            const byte_type* dim = header + 4 + 4 * i;
+            dims_[i] = (size_type(dim[0]) << 24) | (size_type(dim[1]) << 16)
+                     | (size_type(dim[2]) << 8) | size_type(dim[3]);
+
+            if (i == 0) continue;
+
+            // sample without data can't be decoded
+            if (dims_[i] == 0 || sample_size > length / dims_[i]) return;
+            sample_size *= dims_[i];
+        }
+
+        if (dims_[0] > length / sample_size) return;
+
+        data_ = header + data_offset;
+        size_ = dims_[0];
+        sample_size_ = sample_size;
+    }
+
+    bool is_open() const noexcept { return data_ != nullptr; }
+
+    // Conversion x' = x * scale + offset, e.g. scale = 1. / 255. for the pixels
+    IdxFile& dequantize(double scale, double offset = 0.) noexcept
+    {
+        scale_ = scale;
+        offset_ = offset;
+
+        return *this;
+    }
+
+    // Treat each sample as label and convert it to the one hot vector of 'classes' elements
+    IdxFile& one_hot(size_type classes) noexcept
+    {
+        classes_ = classes;
+        return *this;
+    }
+
+    size_type size() const noexcept { return size_; }
+    size_type sample_size() const noexcept { return sample_size_; }
+
+    double scale() const noexcept { return scale_; }
+    double offset() const noexcept { return offset_; }
+
+    size_type classes() const noexcept { return classes_; }
+
+    // Number of elements of converted sample
+    size_type features() const noexcept { return classes_ > 0 ? classes_ : sample_size_; }
+
+    const std::vector<size_type>& dims() const noexcept { return dims_; }
+
+    const byte_type* data() const noexcept { return data_; }
+    const byte_type* sample(size_type i) const noexcept { return data_ + i * sample_size_; }
+
+    // Convert sample to the tensor, it will be resized only if it has another size
+    template <class Tensor>
+    void load(size_type i, Tensor& tensor) const
+    {
+        if (tensor.size() != features()) tensor.resize(1, 1, features());
+
+        decode(i, tensor.data());
+    }
+
+    // Convert samples by indices to the reusable batch of tensors
+    template <class Container>
+    void gather(const size_type* indices, size_type count, Container& batch) const
+    {
+        if (batch.size() != count) batch.resize(count);
+
+        for (size_type k = 0; k < count; ++k) load(indices[k], batch[k]);
+    }
+
+    // Convert samples [first, first + count) to the reusable batch of tensors
+    template <class Container>
+    void load(size_type first, size_type count, Container& batch) const
+    {
+        if (batch.size() != count) batch.resize(count);
+
+        for (size_type k = 0; k < count; ++k) load(first + k, batch[k]);
+    }
+
+    // Write converted sample to the 'features()' elements from out
+    template <typename Pointer>
+    void decode(size_type i, Pointer out) const noexcept
+    {
+        using precision_type = typename std::remove_reference<decltype(*out)>::type;
+
+        const byte_type* sample = this->sample(i);
+
+        if (classes_ > 0)
+        {
+            for (size_type j = 0; j < classes_; ++j) out[j] = precision_type(0.);
+            if (*sample < classes_) out[*sample] = precision_type(1.);
+
+            return;
+        }
+
+        const precision_type scale = static_cast<precision_type>(scale_);
+        const precision_type offset = static_cast<precision_type>(offset_);
+
+        for (size_type j = 0; j < sample_size_; ++j)
+            out[j] = static_cast<precision_type>(sample[j]) * scale + offset;
+    }
+};
+
+// Stream converted samples of the IDX file to the Normalizer
+template <class Matrix>
+void rows(const IdxFile& source, std::size_t first, std::size_t count, Matrix& matrix) noexcept
+{
+    auto row = matrix.data();
+
+    for (std::size_t i = first; i < first + count; ++i, row += source.features())
+        source.decode(i, row);
+}
+
+} // namespace data
+
+} // namespace trixy
+
+#endif // TRIXY_DATASET_IDX_HPP
@@ -0,0 +1,244 @@
+#ifndef TRIXY_DATASET_LOADER_HPP
+#define TRIXY_DATASET_LOADER_HPP
+
+#include <atomic> // atomic
+#include <chrono> // microseconds
+#include <condition_variable> // condition_variable
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <functional> // function
+#include <memory> // unique_ptr
+#include <mutex> // mutex, lock_guard, unique_lock
+#include <random> // mt19937_64
+#include <thread> // thread, yield, sleep_for
+#include <vector> // vector
+
+#include <Trixy/Neuro/Dataset/Source.hpp>
+
+namespace trixy
+{
+
+namespace data
+{
+
+// Background mini-batch pipeline: worker threads shuffle, gather, convert and transform
+// the next batches, while the current one is being trained on.
+// Batches are passed through the bounded ring of reusable slots, each slot has
+// an atomic sequence number: slot of batch k is free for the worker when sequence == k,
+// and ready for the consumer when sequence == k + 1.
+// Batch numbers are claimed by the atomic counter, and each worker repeats the shuffles
+// of the epochs on own copy of the order, so the claim takes no lock.
+// Workers which wait for a free slot are parked on the condition variable.
+// Batches are consumed in order, so result doesn't depend on the number of workers.
+// Sources MUST outlive the loader
+template <class TypeSet, class InputSource, class OutputSource = InputSource>
+class DataLoader
+{
+public:
+    template <typename T>
+    using Container             = typename TypeSet::template Container<T>;
+
+    using Tensor                = typename TypeSet::Tensor;
+    using size_type             = typename TypeSet::size_type;
+
+    // Decode or augment batch in place on the worker thread
+    using Transform             = std::function<void(Container<Tensor>& input, Container<Tensor>& target)>;
+
+    struct Batch
+    {
+        Container<Tensor> input;
+        Container<Tensor> target;
+    };
+
+private:
+    struct Slot
+    {
+        std::atomic<size_type> sequence;
+        Batch batch;
+    };
+
+private:
+    const InputSource& idata_;
+    const OutputSource& odata_;
+
+    size_type batch_size_;
+    size_type batches_;             ///< number of batches per epoch
+    size_type capacity_;
+    size_type number_of_workers_;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    Transform transform_;
+
+    bool shuffle_;
+    std::mt19937_64 generator_;     ///< initial state, each worker takes own copy
+
+    std::atomic<size_type> claimed_; ///< number of batches which are taken by workers
+
+    size_type consumed_;            ///< number of batches which are released by consumer
+
+    std::mutex park_mutex_;
+    std::condition_variable park_;  ///< workers wait here for a free slot
+
+    std::atomic<bool> stop_;
+    std::vector<std::thread> workers_;
+
+public:
+    DataLoader(const InputSource& idata,
+               const OutputSource& odata,
+               size_type batch_size,
+               size_type number_of_workers = 1,
+               size_type capacity = 4)
+        : idata_(idata), odata_(odata)
+        , batch_size_(batch_size < idata.size() ? batch_size : idata.size())
+        , batches_(batch_size_ > 0 ? idata.size() / batch_size_ : 0)
+        , capacity_(capacity > 0 ? capacity : 1)
+        , number_of_workers_(number_of_workers > 0 ? number_of_workers : 1)
+        , slots_(new Slot [capacity_])
+        , transform_(nullptr)
+        , shuffle_(false), generator_()
+        , claimed_(0), consumed_(0)
+        , park_mutex_(), park_()
+        , stop_(false), workers_()
+    {
+        for (size_type i = 0; i < capacity_; ++i) slots_[i].sequence.store(i);
+    }
+
+    ~DataLoader()
+    {
+        stop();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    DataLoader(const DataLoader&) = delete;
+    DataLoader& operator= (const DataLoader&) = delete;
+
+    // Shuffle samples at the beginning of each epoch, MUST be set before the first acquire()
+    DataLoader& shuffle(std::uint64_t seed)
+    {
+        shuffle_ = true;
+        generator_.seed(seed);
+
+        return *this;
+    }
+
+    // MUST be set before the first acquire()
+    DataLoader& transform(Transform function)
+    {
+        transform_ = function;
+        return *this;
+    }
+
+    size_type batch_size() const noexcept { return batch_size_; }
+    size_type batches() const noexcept { return batches_; }
+
+    // Block until the next batch is ready, it stays valid until release().
+    // MUST NOT be called if there are no batches (empty source or zero batch size)
+    const Batch& acquire()
+    {
+        if (workers_.empty()) start();
+
+        Slot& slot = slots_[consumed_ % capacity_];
+        wait(slot.sequence, consumed_ + 1);
+
+        return slot.batch;
+    }
+
+    // Give the slot of the last acquired batch back to the workers
+    void release()
+    {
+        Slot& slot = slots_[consumed_ % capacity_];
+        slot.sequence.store(consumed_ + capacity_, std::memory_order_release);
+
+        ++consumed_;
+
+        notify();
+    }
+
+private:
+    void start()
+    {
+        if (batches_ == 0) return;
+
+        workers_.reserve(number_of_workers_);
+
+        for (size_type i = 0; i < number_of_workers_; ++i)
+            workers_.emplace_back(&DataLoader::run, this);
+    }
+
+    void run()
+    {
+        // order of the epoch is shuffled from the order of the previous one by the same generator
+        std::vector<size_type> order(idata_.size());
+        for (size_type i = 0; i < order.size(); ++i) order[i] = i;
+
+        std::mt19937_64 generator = generator_;
+        size_type epoch = 0;
+
+        while (true)
+        {
+            const size_type k = claimed_.fetch_add(1, std::memory_order_relaxed);
+
+            Slot& slot = slots_[k % capacity_];
+            if (not park(slot.sequence, k)) return;
+
+            for (; shuffle_ && epoch <= k / batches_; ++epoch)
+                data::shuffle(order.data(), order.data() + order.size(), generator);
+
+            const size_type* indices = order.data() + (k % batches_) * batch_size_;
+
+            data::gather(idata_, indices, batch_size_, slot.batch.input);
+            data::gather(odata_, indices, batch_size_, slot.batch.target);
+
+            if (transform_) transform_(slot.batch.input, slot.batch.target);
+
+            slot.sequence.store(k + 1, std::memory_order_release);
+        }
+    }
+
+    void stop()
+    {
+        stop_.store(true);
+        notify();
+    }
+
+    // Wake parked workers, the lock orders the notification after their check
+    void notify()
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_.notify_all();
+    }
+
+    // Park the worker until the slot is free for the batch, return false if the loader is stopped
+    bool park(const std::atomic<size_type>& sequence, size_type value)
+    {
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        park_.wait(lock, [this, &sequence, value]
+        {
+            return stop_.load() || sequence.load(std::memory_order_acquire) == value;
+        });
+
+        return not stop_.load();
+    }
+
+    // Consumer spins, then yields and sleeps until the sequence reaches value,
+    // return false if the loader is stopped
+    bool wait(const std::atomic<size_type>& sequence, size_type value) const
+    {
+        for (size_type spin = 0; sequence.load(std::memory_order_acquire) != value; ++spin)
+        {
+            if (stop_.load(std::memory_order_relaxed)) return false;
+
+            if (spin < 64) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        return true;
+    }
+};
+
+} // namespace data
+
+} // namespace trixy
+
+#endif // TRIXY_DATASET_LOADER_HPP
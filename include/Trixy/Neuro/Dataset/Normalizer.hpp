@@ -0,0 +1,203 @@
+#ifndef TRIXY_DATASET_NORMALIZER_HPP
+#define TRIXY_DATASET_NORMALIZER_HPP
+
+#include <cmath> // sqrt
+#include <cstddef> // size_t
+
+#include <Trixy/Lique/Tool.hpp>
+
+#include <Trixy/Lique/Detail/FunctionDetail.hpp>
+
+namespace trixy
+{
+
+namespace data
+{
+
+// Copy samples [first, first + count) of the source to the rows of matrix.
+// Default version works with indexable containers of tensors,
+// other dataset sources provide own overload to stream their data
+template <class Source, class Matrix>
+void rows(const Source& source, std::size_t first, std::size_t count, Matrix& matrix) noexcept
+{
+    auto row = matrix.data();
+
+    for (std::size_t i = first; i < first + count; ++i)
+    {
+        const auto& sample = source[i];
+
+        lique::detail::copy(row, row + sample.size(), sample.data());
+        row += sample.size();
+    }
+}
+
+// Per feature standardization x' = (x - mean) / std.
+// Statistics are accumulated in the single pass by Welford's method,
+// so the dataset can be processed chunk by chunk and states of different chunks
+// (or threads) can be merged with operator+=.
+// Scales are refreshed by chunk update, merge and reset, single sample updates leave them
+// for finalize(), so transform() is read only and can run on many threads at once.
+// TypeSet can be trixy::TypeSet or network type
+template <class TypeSet>
+class Normalizer
+{
+public:
+    template <typename T>
+    using Container             = typename TypeSet::template Container<T>;
+
+    using Vector                = typename TypeSet::Vector;
+    using Matrix                = typename TypeSet::Matrix;
+    using Tensor                = typename TypeSet::Tensor;
+
+    using precision_type        = typename TypeSet::precision_type;
+    using size_type             = typename TypeSet::size_type;
+
+private:
+    static constexpr double epsilon = 1e-8; ///< prevent division by zero for constant features
+
+private:
+    size_type features_;
+    size_type count_;
+
+    lique::Vector<double> mean_;
+    lique::Vector<double> m2_;      ///< sum of squared deviations from the mean
+
+    Vector scale_;                  ///< 1 / std
+    Vector shift_;                  ///< -mean / std
+
+public:
+    explicit Normalizer(size_type features = 0)
+        : features_(features), count_(0)
+        , mean_(features, 0.), m2_(features, 0.)
+        , scale_(features, precision_type(1.)), shift_(features, precision_type(0.))
+    {
+    }
+
+    // Sample is any tensor with 'features' elements, call finalize() after the last one
+    template <class Sample>
+    void update(const Sample& sample) noexcept
+    {
+        auto x = sample.data();
+
+        ++count_;
+        const double inverse_count = 1. / static_cast<double>(count_);
+
+        for (size_type j = 0; j < features_; ++j)
+        {
+            const double delta = x[j] - mean_(j);
+
+            mean_(j) += delta * inverse_count;
+            m2_(j) += delta * (x[j] - mean_(j));
+        }
+    }
+
+    // Each row of the chunk is a sample, chunk statistics are computed in parallel
+    void update(const Matrix& chunk)
+    {
+        const size_type rows = chunk.shape().height;
+        if (rows == 0) return;
+
+        lique::Vector<double> mean;
+        lique::Vector<double> variance;
+
+        lique::moments(chunk, lique::Axis::X, mean, variance);
+        variance.join(static_cast<double>(rows)); // to sum of squared deviations
+
+        lique::detail::merge_moments(count_, mean_.data(), m2_.data(),
+                                     rows, mean.data(), variance.data(), features_);
+        count_ += rows;
+
+        finalize();
+    }
+
+    // Single pass over the source by chunks of 'chunk_size' samples,
+    // only one chunk is materialized at once
+    template <class Source>
+    void fit(const Source& source, size_type chunk_size = 4096)
+    {
+        Matrix chunk(chunk_size, features_);
+
+        for (size_type first = 0; first < source.size(); first += chunk_size)
+        {
+            const size_type count = first + chunk_size < source.size() ? chunk_size : source.size() - first;
+
+            if (count != chunk.shape().height) chunk.resize(count, features_);
+
+            rows(source, first, count, chunk);
+            update(chunk);
+        }
+    }
+
+    Normalizer& operator+= (const Normalizer& normalizer) noexcept
+    {
+        lique::detail::merge_moments(count_, mean_.data(), m2_.data(),
+                                     normalizer.count_, normalizer.mean_.data(), normalizer.m2_.data(),
+                                     features_);
+        count_ += normalizer.count_;
+
+        finalize();
+
+        return *this;
+    }
+
+    Normalizer& merge(const Normalizer& normalizer) noexcept { return *this += normalizer; }
+
+    void reset() noexcept
+    {
+        count_ = 0;
+
+        mean_.fill(0.);
+        m2_.fill(0.);
+
+        finalize();
+    }
+
+    // Compute scales from the current statistics
+    void finalize() noexcept
+    {
+        for (size_type j = 0; j < features_; ++j)
+        {
+            const double scale = 1. / std::sqrt(variance(j) + epsilon);
+
+            scale_(j) = static_cast<precision_type>(scale);
+            shift_(j) = static_cast<precision_type>(-mean_(j) * scale);
+        }
+    }
+
+    // Apply x' = x * scale + shift to the 'count' samples stored one by one from data
+    void transform(precision_type* data, size_type count = 1) const noexcept
+    {
+        const precision_type* scale = scale_.data();
+        const precision_type* shift = shift_.data();
+
+        for (size_type i = 0; i < count; ++i, data += features_)
+            for (size_type j = 0; j < features_; ++j)
+                data[j] = data[j] * scale[j] + shift[j];
+    }
+
+    void transform(Tensor& sample) const noexcept { transform(sample.data()); }
+    void transform(Matrix& samples) const noexcept { transform(samples.data(), samples.shape().height); }
+
+    void transform(Container<Tensor>& samples) const noexcept
+    {
+        for (auto& sample : samples) transform(sample.data());
+    }
+
+    size_type features() const noexcept { return features_; }
+    size_type count() const noexcept { return count_; }
+
+    const lique::Vector<double>& mean() const noexcept { return mean_; }
+
+    double variance(size_type j) const noexcept
+    {
+        return count_ == 0 ? 0. : m2_(j) / static_cast<double>(count_);
+    }
+
+    double std(size_type j) const noexcept { return std::sqrt(variance(j)); }
+};
+
+} // namespace data
+
+} // namespace trixy
+
+#endif // TRIXY_DATASET_NORMALIZER_HPP
@@ -0,0 +1,128 @@
+#ifndef TRIXY_DATASET_SOURCE_HPP
+#define TRIXY_DATASET_SOURCE_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <limits> // numeric_limits
+#include <type_traits> // decay, is_integral
+#include <utility> // swap, declval
+
+#include <Trixy/Container/Container.hpp>
+
+namespace trixy
+{
+
+namespace data
+{
+
+// Dataset source is any type with size(), load(first, count, batch) and
+// gather(indices, count, batch) members, which fill the reusable batch of tensors,
+// e.g. data::Dataset or data::IdxFile. Containers of tensors are supported
+// by the overloads below, they copy samples to the batch
+template <class Source, class Batch>
+void gather(const Source& source, const std::size_t* indices, std::size_t count, Batch& batch)
+{
+    source.gather(indices, count, batch);
+}
+
+template <class Source, class Batch>
+void load(const Source& source, std::size_t first, std::size_t count, Batch& batch)
+{
+    source.load(first, count, batch);
+}
+
+template <class Tensor, class Batch>
+void gather(const utility::Container<Tensor>& source, const std::size_t* indices, std::size_t count, Batch& batch)
+{
+    if (batch.size() != count) batch.resize(count);
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Tensor& sample = source[indices[k]];
+
+        if (batch[k].size() != sample.size()) batch[k].resize(sample.shape());
+        batch[k].copy(sample);
+    }
+}
+
+template <class Tensor, class Batch>
+void load(const utility::Container<Tensor>& source, std::size_t first, std::size_t count, Batch& batch)
+{
+    if (batch.size() != count) batch.resize(count);
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Tensor& sample = source[first + k];
+
+        if (batch[k].size() != sample.size()) batch[k].resize(sample.shape());
+        batch[k].copy(sample);
+    }
+}
+
+namespace detail
+{
+
+// Random bits of one call: by max() of the standard generators, otherwise by the result type
+template <class Generator>
+auto digits(int) -> decltype(Generator::max(), int())
+{
+    int digits = 0;
+    for (auto max = static_cast<std::uint64_t>(Generator::max()); max != 0; max >>= 1) ++digits;
+
+    return digits;
+}
+
+template <class Generator>
+int digits(long)
+{
+    using result_type = typename std::decay<decltype(std::declval<Generator&>()())>::type;
+    static_assert(std::is_integral<result_type>::value, "Generator should return integral values.");
+
+    return std::numeric_limits<result_type>::digits;
+}
+
+} // namespace detail
+
+// Uniform 64 bit value, values of narrower generators are concatenated.
+// Generator MUST return uniform values from [0, max()] with max() + 1 being the power of two,
+// or over all non-negative values of its result type if it has no max(),
+// e.g. std::mt19937_64, std::mt19937 or std::rand where RAND_MAX is INT_MAX
+template <class Generator>
+std::uint64_t draw(Generator& generator)
+{
+    const int digits = detail::digits<Generator>(0);
+
+    std::uint64_t value = static_cast<std::uint64_t>(generator());
+    for (int bits = digits; bits < 64; bits += digits)
+        value = (value << digits) | static_cast<std::uint64_t>(generator());
+
+    return value;
+}
+
+// Unbiased random value from [0, bound), see draw() for the generator requirements
+template <class Generator>
+std::uint64_t bounded(Generator& generator, std::uint64_t bound)
+{
+    // reject values from the incomplete last interval
+    const std::uint64_t limit = std::uint64_t(-1) - (std::uint64_t(-1) % bound + 1) % bound;
+
+    std::uint64_t value;
+    do value = draw(generator);
+    while (value > limit);
+
+    return value % bound;
+}
+
+// Fisher-Yates shuffle
+template <typename Index, class Generator>
+void shuffle(Index* first, Index* last, Generator& generator)
+{
+    for (std::size_t n = static_cast<std::size_t>(last - first); n > 1; --n)
+        std::swap(first[n - 1], first[bounded(generator, n)]);
+}
+
+} // namespace data
+
+} // namespace trixy
+
+#endif // TRIXY_DATASET_SOURCE_HPP
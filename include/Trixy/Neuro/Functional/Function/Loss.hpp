@@ -1,12 +1,15 @@
 #ifndef TRIXY_FUNCTION_LOSS_HPP
 #define TRIXY_FUNCTION_LOSS_HPP
 
-#include <cmath> // log, fabs, tanh, cosh
+#include <cstddef> // size_t
+#include <cmath> // log, exp, fabs, tanh, cosh
 
 #include <Trixy/Neuro/Functional/Function/Base.hpp>
 
 #include <Trixy/Range/Base.hpp>
 
+#include <Trixy/Detail/TrixyMeta.hpp>
+
 #include <Trixy/Neuro/Functional/Function/Detail/MacroScope.hpp>
 
 namespace trixy
@@ -61,7 +64,7 @@ void categorical_cross_entropy_derived(Buffer& result, const Target& y_true, con
 template <typename Precision, class Target, class Prediction>
 void mean_squared_error(Precision& result, const Target& y_true, const Prediction& y_pred) noexcept
 {
-    static Precision f;
+    Precision f;
 
     auto target = y_true.data();
     auto end    = y_true.data() + y_true.size();
@@ -142,7 +145,7 @@ void mean_absolute_error_derived(Buffer& result, const Target& y_true, const Pre
 template <typename Precision, class Target, class Prediction>
 void mean_squared_log_error(Precision& result, const Target& y_true, const Prediction& y_pred) noexcept
 {
-    static Precision f;
+    Precision f;
 
     auto target = y_true.data();
     auto end    = y_true.data() + y_true.size();
@@ -317,6 +320,70 @@ void logcosh_derived(Buffer& result, const Target& y_true, const Prediction& y_p
     }
 }
 
+template <typename Pointer>
+auto max_element_value(Pointer first, Pointer last) noexcept -> meta::decay<decltype(*first)>
+{
+    meta::decay<decltype(*first)> max = *first;
+    for (++first; first != last; ++first)
+        if (max < *first) max = *first;
+
+    return max;
+}
+
+// log(sum(exp(z - shift))), where shift is the max of z to prevent overflow of exp
+template <typename Pointer, typename Precision>
+Precision log_sum_exp(Pointer first, Pointer last, Precision shift) noexcept
+{
+    Precision sum = 0.;
+    while (first != last) sum += std::exp(*first++ - shift);
+
+    return std::log(sum);
+}
+
+template <typename Precision, class Target, class Logits>
+void softmax_cross_entropy(Precision& result, const Target& y_true, const Logits& logits) noexcept
+{
+    auto target = y_true.data();
+    auto end    = y_true.data() + y_true.size();
+
+    auto z      = logits.data();
+
+    const Precision max = max_element_value(logits.data(), logits.data() + logits.size());
+    const Precision lse = log_sum_exp(logits.data(), logits.data() + logits.size(), max);
+
+    // -sum(y * log(softmax(z))) = sum(y * (lse - (z - max)))
+    result = Precision{};
+    while (target != end)
+    {
+        result += (*target) * (lse - (*z - max));
+
+        ++target;
+        ++z;
+    }
+}
+
+template <class Buffer, class Target, class Logits>
+void softmax_cross_entropy_derived(Buffer& result, const Target& y_true, const Logits& logits) noexcept
+{
+    auto first  = result.data();
+    auto last   = result.data() + result.size();
+
+    auto target = y_true.data();
+    auto z      = logits.data();
+
+    const auto max = max_element_value(logits.data(), logits.data() + logits.size());
+    const auto lse = log_sum_exp(logits.data(), logits.data() + logits.size(), max);
+
+    // gradient of loss with respect to logits: softmax(z) - y
+    while (first != last)
+    {
+        *first++ = std::exp((*z - max) - lse) - *target;
+
+        ++target;
+        ++z;
+    }
+}
+
 TRIXY_FUNCTION_GENERIC_LOSS_HELPER(MSE, mean_squared_error, mean_squared_error_derived);
 TRIXY_FUNCTION_GENERIC_LOSS_HELPER(MAE, mean_absolute_error, mean_absolute_error_derived);
 TRIXY_FUNCTION_GENERIC_LOSS_HELPER(CCE, categorical_cross_entropy, mean_squared_error_derived);
@@ -325,6 +392,62 @@ TRIXY_FUNCTION_GENERIC_LOSS_HELPER(MSLE, mean_squared_log_error, mean_squared_lo
 TRIXY_FUNCTION_GENERIC_LOSS_HELPER(NLL, negative_log_likelihood, negative_log_likelihood_derived_softmax);
 TRIXY_FUNCTION_GENERIC_LOSS_HELPER(LC, logcosh, logcosh_derived);
 
+// Fused softmax + categorical cross entropy output head.
+// Prediction MUST be a raw logits, so the output layer should use Identity activation,
+// then backward of the output layer takes softmax(z) - y directly as a delta.
+template <typename Precision = double>
+class SoftmaxCrossEntropy : public ILoss<Precision>
+{
+public:
+    using Base = ILoss<Precision>;
+
+    using typename Base::precision_type;
+    using typename Base::Range;
+
+    using size_type = std::size_t;
+
+public:
+    SoftmaxCrossEntropy() : Base() {}
+
+    void f(precision_type& result, const Range y_true, const Range y_pred) noexcept
+    { softmax_cross_entropy(result, y_true, y_pred); }
+
+    void df(Range result, const Range y_true, const Range y_pred) noexcept
+    { softmax_cross_entropy_derived(result, y_true, y_pred); }
+
+    void operator() (precision_type& result, const Range y_true, const Range y_pred) noexcept
+    { softmax_cross_entropy(result, y_true, y_pred); }
+
+    // Mean loss of the batch, where targets and logits are stored row by row
+    // with 'classes' elements per row
+    precision_type batch(const Range y_true, const Range y_pred, size_type classes) const noexcept
+    {
+        if (classes == 0) return precision_type{};
+
+        const size_type batch_size = y_pred.size() / classes;
+        if (batch_size == 0) return precision_type{};
+
+        auto target = y_true.data();
+        auto z      = y_pred.data();
+
+        precision_type result = 0.;
+
+        for (size_type row = 0; row < batch_size; ++row)
+        {
+            const precision_type max = max_element_value(z, z + classes);
+            const precision_type lse = log_sum_exp(z, z + classes, max);
+
+            for (size_type j = 0; j < classes; ++j)
+                result += target[j] * (lse - (z[j] - max));
+
+            target += classes;
+            z      += classes;
+        }
+
+        return result / static_cast<precision_type>(batch_size);
+    }
+};
+
 } // namespace loss
 
 } // namespace functional
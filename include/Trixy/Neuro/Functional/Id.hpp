@@ -57,6 +57,20 @@ enum class OptimizationId : std::uint8_t
     ada_grad = 5,           ///< Adaptive Gradient algorithm (stable)
     rms_prop = 6,           ///< Root Mean Square Propagation (horny)
     adam = 7,               ///< Adaptive moment estimation (quick)
+    lamb = 8,               ///< Layer-wise adaptive moments (adam for large batches)
+    lars = 9,               ///< Layer-wise adaptive rate scaling (momentum for large batches)
+    size
+};
+
+enum class InitializationId : std::uint8_t
+{
+    undefined = 0,          ///< default null value
+    he_uniform = 1,         ///< U(-a, a), a = sqrt(6 / fan_in) (for relu)
+    he_normal = 2,          ///< N(0, 2 / fan_in) (for relu)
+    xavier_uniform = 3,     ///< U(-a, a), a = sqrt(6 / (fan_in + fan_out)) (for tanh, sigmoid)
+    xavier_normal = 4,      ///< N(0, 2 / (fan_in + fan_out)) (for tanh, sigmoid)
+    lecun_uniform = 5,      ///< U(-a, a), a = sqrt(3 / fan_in) (for selu)
+    lecun_normal = 6,       ///< N(0, 1 / fan_in) (for selu)
     size
 };
 
@@ -1,6 +1,8 @@
 #ifndef TRIXY_OPTIMIZER_ADA_GRAD_HPP
 #define TRIXY_OPTIMIZER_ADA_GRAD_HPP
 
+#include <vector> // vector
+
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
 
@@ -23,6 +25,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::ada_grad)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -32,6 +36,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
     using typename Base::RangeUnified;
 
 private:
@@ -43,6 +48,8 @@ private:
     Table buff_table_;
     Table optimized_table_;
 
+    std::vector<precision_type*> optimized_;  ///< states of the update_all() parameters
+
     precision_type learning_rate_;
 
 public:
@@ -59,15 +66,7 @@ public:
 
     Optimizer& reset() noexcept
     {
-        auto first = optimized_table_.begin();
-        auto last  = optimized_table_.end();
-
-        while (first != last)
-        {
-            first->fill(0.);
-            ++first;
-        }
-
+        for (auto& state : optimized_table_) state.second.fill(0.);
         return *this;
     }
 
@@ -91,6 +90,34 @@ public:
 
         net.linear.sub(param, buff);
     }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_table_, parameters, count, optimized_);
+
+        const precision_type scale = Base::scale(parameters, count, alpha);
+        const precision_type shrink = Base::decay(learning_rate_);
+        const precision_type rate = learning_rate_;
+
+        auto& optimized = optimized_;
+
+        // velocity = velocity + g * g
+        // w = shrink * w - learning_rate * g / sqrt(velocity)
+        Base::sweep(parameters, count, [parameters, &optimized, rate, shrink, scale](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+            precision_type* velocity = optimized[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const precision_type g = scale * grad[i];
+
+                velocity[i] += g * g;
+                param[i] = shrink * param[i] - rate * g * detail::invert_sqrt(velocity[i]);
+            }
+        });
+    }
 };
 
 template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
@@ -101,6 +128,28 @@ AdaGrad<Net, TypeSet> AdaGradOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_ada_grad_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_ada_grad_optimizer<train::Optimizer<train::OptimizerType::ada_grad, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_ada_grad_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_ada_grad_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_table_);
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_ADA_GRAD_HPP
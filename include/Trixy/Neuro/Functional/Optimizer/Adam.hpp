@@ -1,6 +1,8 @@
 #ifndef TRIXY_OPTIMIZER_ADAM_HPP
 #define TRIXY_OPTIMIZER_ADAM_HPP
 
+#include <vector> // vector
+
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
 
@@ -23,6 +25,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::adam)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -32,6 +36,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
     using typename Base::RangeUnified;
 
 private:
@@ -44,6 +49,9 @@ private:
     Table optimized_m_table_;
     Table optimized_s_table_;
 
+    std::vector<precision_type*> optimized_m_;    ///< states of the update_all() parameters
+    std::vector<precision_type*> optimized_s_;
+
     precision_type learning_rate_;
 
     precision_type beta1, beta2;
@@ -76,23 +84,11 @@ public:
 
     Optimizer& reset() noexcept
     {
-        auto first_m = optimized_m_table_.begin();
-        auto last_m  = optimized_m_table_.end();
-
-        while (first_m != last_m)
-        {
-            first_m->fill(0.);
-            ++first_m;
-        }
-
-        auto first_s = optimized_s_table_.begin();
-        auto last_s  = optimized_m_table_.end();
+        for (auto& state : optimized_m_table_) state.second.fill(0.);
+        for (auto& state : optimized_s_table_) state.second.fill(0.);
 
-        while (first_s != last_s)
-        {
-            first_s->fill(0.);
-            ++first_s;
-        }
+        tbeta1 = 1.;
+        tbeta2 = 1.;
 
         return *this;
     }
@@ -136,6 +132,52 @@ public:
 
         net.linear.sub(param, buff);
     }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_m_table_, parameters, count, optimized_m_);
+        Base::state(optimized_s_table_, parameters, count, optimized_s_);
+
+        // one step for all parameters
+        tbeta1 *= beta1;
+        tbeta2 *= beta2;
+
+        const precision_type decay1 = beta1, rdecay1 = rbeta1;
+        const precision_type decay2 = beta2, rdecay2 = rbeta2;
+
+        const precision_type scale = Base::scale(parameters, count, alpha);
+        const precision_type shrink = Base::decay(learning_rate_);
+
+        const precision_type rate = learning_rate_ / (1. - tbeta1);
+        const precision_type correction = 1. / (1. - tbeta2);
+
+        auto& optimized_m = optimized_m_;
+        auto& optimized_s = optimized_s_;
+
+        // m = beta1 * m + (1 - beta1) * g
+        // s = beta2 * s + (1 - beta2) * g * g
+        // w = shrink * w - learning_rate * m / (1 - beta1 ^ t) / sqrt(s / (1 - beta2 ^ t))
+        Base::sweep(parameters, count,
+            [parameters, &optimized_m, &optimized_s, decay1, rdecay1, decay2, rdecay2, rate, correction, scale, shrink]
+            (size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+
+            precision_type* m = optimized_m[p];
+            precision_type* s = optimized_s[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const precision_type g = scale * grad[i];
+
+                m[i] = decay1 * m[i] + rdecay1 * g;
+                s[i] = decay2 * s[i] + rdecay2 * g * g;
+
+                param[i] = shrink * param[i] - rate * m[i] * detail::invert_sqrt(correction * s[i]);
+            }
+        });
+    }
 };
 
 template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
@@ -146,6 +188,32 @@ Adam<Net, TypeSet> AdamOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_adam_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_adam_optimizer<train::Optimizer<train::OptimizerType::adam, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_adam_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_adam_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_
+                & optimizer.beta1 & optimizer.beta2
+                & optimizer.rbeta1 & optimizer.rbeta2
+                & optimizer.tbeta1 & optimizer.tbeta2;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_m_table_);
+        S::archive_state(archive, optimizer.net, optimizer.optimized_s_table_);
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_ADAM_HPP
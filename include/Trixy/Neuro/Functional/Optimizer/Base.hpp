@@ -50,6 +50,8 @@ public:
     _TRIXY_DEF_OPTIMIZER_HELPER(id_type, ada_grad)
     _TRIXY_DEF_OPTIMIZER_HELPER(id_type, rms_prop)
     _TRIXY_DEF_OPTIMIZER_HELPER(id_type, adam)
+    _TRIXY_DEF_OPTIMIZER_HELPER(id_type, lamb)
+    _TRIXY_DEF_OPTIMIZER_HELPER(id_type, lars)
 
 public:
     template <id_type id> using type_from = switch_type
@@ -61,7 +63,9 @@ public:
         nestorov::type<id>,
         ada_grad::type<id>,
         rms_prop::type<id>,
-        adam::type<id>
+        adam::type<id>,
+        lamb::type<id>,
+        lars::type<id>
     >;
 };
 
@@ -15,4 +15,7 @@
 
 #include <Trixy/Neuro/Functional/Optimizer/Adam.hpp>
 
+#include <Trixy/Neuro/Functional/Optimizer/LAMB.hpp>
+#include <Trixy/Neuro/Functional/Optimizer/LARS.hpp>
+
 #endif // TRIXY_OPTIMIZER_CORE_HPP
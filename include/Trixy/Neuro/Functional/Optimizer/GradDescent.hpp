@@ -24,6 +24,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::grad_descent)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -33,6 +35,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
 
 private:
     Net& net;
@@ -57,6 +60,21 @@ public:
         net.linear.join(grad, learning_rate_);
         net.linear.sub(param, grad);
     }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        const precision_type rate = learning_rate_ * Base::scale(parameters, count, alpha);
+        const precision_type shrink = Base::decay(learning_rate_);
+
+        // w = shrink * w - learning_rate * scale * grad
+        Base::sweep(parameters, count, [parameters, rate, shrink](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+
+            for (size_type i = first; i < last; ++i) param[i] = shrink * param[i] - rate * grad[i];
+        });
+    }
 };
 
 template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
@@ -67,6 +85,26 @@ GradDescent<Net, TypeSet> GradDescentOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_grad_descent_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_grad_descent_optimizer<train::Optimizer<train::OptimizerType::grad_descent, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_grad_descent_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_grad_descent_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_;
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_GRAD_DESCENT_HPP
@@ -1,11 +1,18 @@
 #ifndef TRIXY_OPTIMIZER_INTERFACE_HPP
 #define TRIXY_OPTIMIZER_INTERFACE_HPP
 
+#include <algorithm> // copy
+#include <cmath> // sqrt, fabs
+#include <vector> // vector
+
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
 
 #include <Trixy/Range/View.hpp>
 #include <Trixy/Range/Unified.hpp>
 
+#include <Trixy/Serializer/Core.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
 #include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
 
 #include <Trixy/Detail/MacroScope.hpp>
@@ -20,6 +27,8 @@ template <class Optimizeriable>
 class IOptimizer<Optimizeriable,
     meta::when<meta::is_trixy_net<Optimizeriable>::value>>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net               = Optimizeriable;
 
@@ -29,6 +38,20 @@ public:
     using Range             = utility::Range<precision_type>; // default view range
     using RangeUnified      = utility::Range<precision_type, RangeType::Unified>;
 
+    // Parameter tensor with its gradient for the update_all()
+    struct Parameter
+    {
+        precision_type* param;
+        const precision_type* grad;
+        size_type size;
+    };
+
+private:
+    static constexpr size_type sweep_chunk = 1 << 12;           ///< elements of one task
+    static constexpr size_type sweep_per_thread = 1 << 15;      ///< min elements per thread
+
+    struct Task { size_type p, first, last; };
+
 private:
     template <typename Ret, typename... Args>
     using Func = Ret (*)(void* const, Args...);
@@ -38,6 +61,13 @@ private:
     Func<precision_type> f_get_learning_rate = nullptr;
 
     Func<void, Range, Range> f_update = nullptr;
+    Func<void, const Parameter*, size_type, precision_type> f_update_all = nullptr;
+
+private:
+    precision_type max_norm_ = 0.;      ///< global gradient norm limit, 0 - without clipping
+    precision_type weight_decay_ = 0.;  ///< decoupled weight decay, 0 - without decay
+
+    std::vector<double> sums_;          ///< reusable squared norms of the clipping
 
 protected:
     template <class Derived>
@@ -51,6 +81,9 @@ protected:
 
         f_update = [](void *const self, Range param, Range grad)
         { static_cast<Derived*>(self)->update(param, grad); };
+
+        f_update_all = [](void *const self, const Parameter* parameters, size_type count, precision_type alpha)
+        { static_cast<Derived*>(self)->update_all(parameters, count, alpha); };
     }
 
 public:
@@ -66,11 +99,29 @@ public:
         return f_get_learning_rate(this);
     }
 
-    void update(Range param, Range grad) noexcept
+    // LAMB and LARS forward it to update_all(), so it isn't noexcept
+    void update(Range param, Range grad)
     {
         f_update(this, param, grad);
     }
 
+    // Update all parameters of the net in one call, gradients are scaled by alpha on the fly
+    // and they aren't modified. Unlike update(), step of the optimizer is counted once per call.
+    // Gradient clipping and weight decay are applied only there.
+    // State of new parameters and task lists are allocated here, so it isn't noexcept
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        f_update_all(this, parameters, count, alpha);
+    }
+
+    // Rescale gradients of update_all() if their global norm (after alpha scaling) exceeds max_norm
+    void clip(precision_type max_norm) noexcept { max_norm_ = max_norm; }
+    precision_type clip() const noexcept { return max_norm_; }
+
+    // Decoupled weight decay (AdamW style): w = w - learning_rate * decay * w
+    void weight_decay(precision_type decay) noexcept { weight_decay_ = decay; }
+    precision_type weight_decay() const noexcept { return weight_decay_; }
+
 protected:
     template <class Table>
     static RangeUnified& get(Table& table, Range range)
@@ -83,12 +134,155 @@ protected:
 
         return buff;
     }
+
+    // Take state of each parameter from the table
+    template <class Table>
+    static void state(Table& table, const Parameter* parameters, size_type count,
+                      std::vector<precision_type*>& out)
+    {
+        out.resize(count);
+        for (size_type p = 0; p < count; ++p)
+            out[p] = get(table, Range(parameters[p].param, parameters[p].param + parameters[p].size)).data();
+    }
+
+    // Save or load state of each parameter in the stable order of the net: by layers, then by their tensors.
+    // State is stored as the array of raw values, so it doesn't depend on the tensor addresses.
+    // States which don't match the net are skipped on load
+    template <class Archive, class Table>
+    static void archive_state(Archive& archive, Net& net, Table& table)
+    {
+        std::vector<Parameter> parameters;
+        for (size_type i = 0; i < net.size(); ++i)
+            static_cast<typename Net::ITrainLayer&>(net.layer(i)).parameters(parameters);
+
+        size_type count = parameters.size();
+        archive & count;
+
+        std::vector<precision_type> values;
+        for (size_type p = 0; p < count; ++p)
+        {
+            if (trixy::meta::is_iarchive(archive))
+            {
+                archive & values;
+                if (p >= parameters.size() || values.size() != parameters[p].size) continue;
+
+                auto& state = get(table, Range(parameters[p].param, parameters[p].param + parameters[p].size));
+                std::copy(values.begin(), values.end(), state.data());
+            }
+            else
+            {
+                auto& state = get(table, Range(parameters[p].param, parameters[p].param + parameters[p].size));
+
+                values.assign(state.data(), state.data() + parameters[p].size);
+                archive & values;
+            }
+        }
+    }
+
+    // Gradient factor of update_all(): alpha, reduced by the clipping
+    precision_type scale(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        if (max_norm_ <= 0.) return alpha;
+
+        reduce(parameters, count, sums_, [parameters](size_type p, size_type first, size_type last, double* sum)
+        {
+            const precision_type* grad = parameters[p].grad;
+            for (size_type i = first; i < last; ++i) sum[0] += grad[i] * grad[i];
+        });
+
+        double sum = 0.;
+        for (size_type p = 0; p < count; ++p) sum += sums_[2 * p];
+
+        const double norm = std::fabs(alpha) * std::sqrt(sum);
+
+        return norm > max_norm_ ? static_cast<precision_type>(alpha * max_norm_ / norm) : alpha;
+    }
+
+    // Weight factor of update_all() for the decoupled weight decay
+    precision_type decay(precision_type learning_rate) const noexcept
+    {
+        return 1. - learning_rate * weight_decay_;
+    }
+
+    // Split all parameters by chunks between threads,
+    // function(p, first, last) updates elements [first, last) of the parameter p
+    template <class Function>
+    static void sweep(const Parameter* parameters, size_type count, Function function)
+    {
+        std::vector<Task> tasks;
+        split(parameters, count, tasks);
+
+        trixy::detail::parallel_for(
+            trixy::detail::parallel_info<sweep_per_thread / sweep_chunk>(tasks.size()), tasks.size(),
+            [&tasks, &function](size_type first, size_type last, size_type)
+            {
+                for (size_type t = first; t < last; ++t)
+                    function(tasks[t].p, tasks[t].first, tasks[t].last);
+            }
+        );
+    }
+
+    // Two sums for each parameter, e.g. squared norms of the tensor and its update,
+    // function(p, first, last, sum) adds to the sum[0] and sum[1] of the parameter p.
+    // Chunks are split between threads as in sweep(), out[2 * p + k] is k-th sum of the parameter p
+    template <class Function>
+    static void reduce(const Parameter* parameters, size_type count, std::vector<double>& out, Function function)
+    {
+        std::vector<Task> tasks;
+        split(parameters, count, tasks);
+
+        auto info = trixy::detail::parallel_info<sweep_per_thread / sweep_chunk>(tasks.size());
+        std::vector<std::vector<double>> partial(info.first, std::vector<double>(2 * count, 0.));
+
+        trixy::detail::parallel_for(info, tasks.size(),
+            [&tasks, &partial, &function](size_type first, size_type last, size_type thread)
+            {
+                double* sums = partial[thread].data();
+                for (size_type t = first; t < last; ++t)
+                    function(tasks[t].p, tasks[t].first, tasks[t].last, sums + 2 * tasks[t].p);
+            }
+        );
+
+        out.assign(2 * count, 0.);
+        for (const auto& sums : partial)
+            for (size_type k = 0; k < out.size(); ++k) out[k] += sums[k];
+    }
+
+private:
+    static void split(const Parameter* parameters, size_type count, std::vector<Task>& tasks)
+    {
+        for (size_type p = 0; p < count; ++p)
+        {
+            const size_type size = parameters[p].size;
+
+            for (size_type first = 0; first < size; first += sweep_chunk)
+                tasks.push_back({ p, first, first + sweep_chunk < size ? first + sweep_chunk : size });
+        }
+    }
 };
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_ioptimizer : std::false_type {};
+template <class Net> struct is_ioptimizer<train::IOptimizer<Net>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_ioptimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_ioptimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & optimizer.max_norm_ & optimizer.weight_decay_;
+    )
+SERIALIZABLE_INIT()
+
 #include <Trixy/Detail/MacroScope.hpp>
 
 #endif // TRIXY_OPTIMIZER_INTERFACE_HPP
@@ -0,0 +1,225 @@
+#ifndef TRIXY_OPTIMIZER_LAMB_HPP
+#define TRIXY_OPTIMIZER_LAMB_HPP
+
+#include <cmath> // sqrt
+#include <cstdint> // uintptr_t
+#include <vector> // vector
+
+#include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
+#include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+#include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
+
+#include <Trixy/Neuro/Detail/MacroScope.hpp>
+
+namespace trixy
+{
+
+namespace train
+{
+
+template <class Optimizeriable, class TypeSet = OptimizerTypeSet>
+using LAMB
+    = TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::lamb);
+
+// Adam with the trust ratio ||w|| / ||r|| for each tensor, where r is the adam step
+// with the weight decay. Weight decay is a part of the step, so it's scaled by the ratio too
+TRIXY_OPTIMIZER_TEMPLATE()
+class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::lamb)
+    : public IOptimizer<Optimizeriable>
+{
+    SERIALIZABLE_ACCESS()
+
+public:
+    using Net  = Optimizeriable;
+    using Base = IOptimizer<Net>;
+
+public:
+    using typename Base::precision_type;
+    using typename Base::size_type;
+
+    using typename Base::Range;
+    using typename Base::Parameter;
+    using typename Base::RangeUnified;
+
+private:
+    using Table = OptimizerTypeSet::template Table<std::uintptr_t, RangeUnified>;
+
+private:
+    Net& net;
+
+    Table optimized_m_table_;
+    Table optimized_s_table_;
+
+    std::vector<precision_type*> optimized_m_;    ///< states of the update_all() parameters
+    std::vector<precision_type*> optimized_s_;
+
+    std::vector<double> norms_;                   ///< squared norms of each tensor and its step
+    std::vector<precision_type> rates_;           ///< learning rate with trust ratio of each tensor
+
+    precision_type learning_rate_;
+
+    precision_type beta1, beta2;
+    precision_type rbeta1, rbeta2;
+
+    precision_type tbeta1, tbeta2;
+
+public:
+    Optimizer(Net& network,
+              precision_type learning_rate,
+              precision_type beta1 = 0.9,
+              precision_type beta2 = 0.999)
+        : Base()
+        , net(network)
+        , optimized_m_table_()
+        , optimized_s_table_()
+        , learning_rate_(learning_rate)
+        , beta1(beta1)
+        , beta2(beta2)
+    {
+        this->template initialize<Optimizer>();
+
+        rbeta1 = 1. - beta1;
+        rbeta2 = 1. - beta2;
+
+        tbeta1 = 1.;
+        tbeta2 = 1.;
+    }
+
+    Optimizer& reset() noexcept
+    {
+        for (auto& state : optimized_m_table_) state.second.fill(0.);
+        for (auto& state : optimized_s_table_) state.second.fill(0.);
+
+        tbeta1 = 1.;
+        tbeta2 = 1.;
+
+        return *this;
+    }
+
+    precision_type learning_rate() const noexcept { return learning_rate_; }
+    void learning_rate(precision_type value) noexcept { learning_rate_ = value; }
+
+    void update(Range param, Range grad)
+    {
+        const Parameter parameter = { param.data(), grad.data(), static_cast<size_type>(param.size()) };
+        update_all(&parameter, 1, 1.);
+    }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_m_table_, parameters, count, optimized_m_);
+        Base::state(optimized_s_table_, parameters, count, optimized_s_);
+
+        // one step for all parameters
+        tbeta1 *= beta1;
+        tbeta2 *= beta2;
+
+        const precision_type decay1 = beta1, rdecay1 = rbeta1;
+        const precision_type decay2 = beta2, rdecay2 = rbeta2;
+
+        const precision_type scale = Base::scale(parameters, count, alpha);
+        const precision_type decay = Base::weight_decay();
+
+        const precision_type correction1 = 1. / (1. - tbeta1);
+        const precision_type correction2 = 1. / (1. - tbeta2);
+
+        auto& optimized_m = optimized_m_;
+        auto& optimized_s = optimized_s_;
+
+        // m = beta1 * m + (1 - beta1) * g
+        // s = beta2 * s + (1 - beta2) * g * g
+        // r = m / (1 - beta1 ^ t) / sqrt(s / (1 - beta2 ^ t)) + decay * w
+        auto step = [&optimized_m, &optimized_s, correction1, correction2, decay]
+                    (size_type p, size_type i, precision_type w) -> precision_type
+        {
+            return correction1 * optimized_m[p][i] * detail::invert_sqrt(correction2 * optimized_s[p][i])
+                 + decay * w;
+        };
+
+        // moments update is fused with the norms of w and r
+        Base::reduce(parameters, count, norms_,
+            [parameters, &optimized_m, &optimized_s, &step, decay1, rdecay1, decay2, rdecay2, scale]
+            (size_type p, size_type first, size_type last, double* sum)
+        {
+            const precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+
+            precision_type* m = optimized_m[p];
+            precision_type* s = optimized_s[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const precision_type g = scale * grad[i];
+
+                m[i] = decay1 * m[i] + rdecay1 * g;
+                s[i] = decay2 * s[i] + rdecay2 * g * g;
+
+                const precision_type r = step(p, i, param[i]);
+
+                sum[0] += param[i] * param[i];
+                sum[1] += r * r;
+            }
+        });
+
+        // trust ratio = ||w|| / ||r||, or 1 if any of them is zero
+        rates_.resize(count);
+        for (size_type p = 0; p < count; ++p)
+        {
+            const double w = norms_[2 * p];
+            const double r = norms_[2 * p + 1];
+
+            rates_[p] = w > 0. && r > 0. ? learning_rate_ * std::sqrt(w / r) : learning_rate_;
+        }
+
+        auto& rates = rates_;
+
+        // w = w - learning_rate * trust ratio * r
+        Base::sweep(parameters, count, [parameters, &rates, &step](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type rate = rates[p];
+
+            for (size_type i = first; i < last; ++i) param[i] -= rate * step(p, i, param[i]);
+        });
+    }
+};
+
+template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
+LAMB<Net, TypeSet> LAMBOptimizer(Net& net, Args&&... args)
+{
+    return LAMB<Net, TypeSet>(net, std::forward<Args>(args)...);
+}
+
+} // namespace train
+
+namespace meta
+{
+
+template <typename T> struct is_lamb_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_lamb_optimizer<train::Optimizer<train::OptimizerType::lamb, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
+} // namespace trixy
+
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_lamb_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_lamb_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_
+                & optimizer.beta1 & optimizer.beta2
+                & optimizer.rbeta1 & optimizer.rbeta2
+                & optimizer.tbeta1 & optimizer.tbeta2;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_m_table_);
+        S::archive_state(archive, optimizer.net, optimizer.optimized_s_table_);
+    )
+SERIALIZABLE_INIT()
+
+#endif // TRIXY_OPTIMIZER_LAMB_HPP
@@ -0,0 +1,178 @@
+#ifndef TRIXY_OPTIMIZER_LARS_HPP
+#define TRIXY_OPTIMIZER_LARS_HPP
+
+#include <cmath> // sqrt, fabs
+#include <cstdint> // uintptr_t
+#include <vector> // vector
+
+#include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
+#include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
+
+#include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
+
+#include <Trixy/Neuro/Detail/MacroScope.hpp>
+
+namespace trixy
+{
+
+namespace train
+{
+
+template <class Optimizeriable, class TypeSet = OptimizerTypeSet>
+using LARS
+    = TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::lars);
+
+// Momentum with the local learning rate
+// trust * ||w|| / (||g|| + decay * ||w||) for each tensor.
+// Weight decay is a part of the step, so it's scaled by the local rate too
+TRIXY_OPTIMIZER_TEMPLATE()
+class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::lars)
+    : public IOptimizer<Optimizeriable>
+{
+    SERIALIZABLE_ACCESS()
+
+public:
+    using Net  = Optimizeriable;
+    using Base = IOptimizer<Net>;
+
+public:
+    using typename Base::precision_type;
+    using typename Base::size_type;
+
+    using typename Base::Range;
+    using typename Base::Parameter;
+    using typename Base::RangeUnified;
+
+private:
+    using Table = OptimizerTypeSet::template Table<std::uintptr_t, RangeUnified>;
+
+private:
+    Net& net;
+
+    Table optimized_table_;
+
+    std::vector<precision_type*> optimized_;  ///< states of the update_all() parameters
+
+    std::vector<double> norms_;               ///< squared norms of each tensor and its gradient
+    std::vector<precision_type> rates_;       ///< local learning rate of each tensor
+
+    precision_type learning_rate_;
+    precision_type momentum_;
+    precision_type trust_;
+
+public:
+    Optimizer(Net& network,
+              precision_type learning_rate,
+              precision_type momentum = 0.9,
+              precision_type trust = 0.001)
+        : Base()
+        , net(network)
+        , optimized_table_()
+        , learning_rate_(learning_rate)
+        , momentum_(momentum)
+        , trust_(trust)
+    {
+        this->template initialize<Optimizer>();
+    }
+
+    Optimizer& reset() noexcept
+    {
+        for (auto& state : optimized_table_) state.second.fill(0.);
+        return *this;
+    }
+
+    precision_type learning_rate() const noexcept { return learning_rate_; }
+    void learning_rate(precision_type value) noexcept { learning_rate_ = value; }
+
+    void update(Range param, Range grad)
+    {
+        const Parameter parameter = { param.data(), grad.data(), static_cast<size_type>(param.size()) };
+        update_all(&parameter, 1, 1.);
+    }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_table_, parameters, count, optimized_);
+
+        const precision_type scale = Base::scale(parameters, count, alpha);
+        const precision_type decay = Base::weight_decay();
+        const precision_type momentum = momentum_;
+
+        Base::reduce(parameters, count, norms_, [parameters](size_type p, size_type first, size_type last, double* sum)
+        {
+            const precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+
+            for (size_type i = first; i < last; ++i)
+            {
+                sum[0] += param[i] * param[i];
+                sum[1] += grad[i] * grad[i];
+            }
+        });
+
+        // local rate = learning_rate * trust * ||w|| / (||g|| + decay * ||w||), or learning_rate if any norm is zero
+        rates_.resize(count);
+        for (size_type p = 0; p < count; ++p)
+        {
+            const double w = std::sqrt(norms_[2 * p]);
+            const double g = std::fabs(scale) * std::sqrt(norms_[2 * p + 1]);
+
+            rates_[p] = w > 0. && g > 0. ? learning_rate_ * trust_ * w / (g + decay * w) : learning_rate_;
+        }
+
+        auto& optimized = optimized_;
+        auto& rates = rates_;
+
+        // velocity = momentum * velocity + local rate * (g + decay * w)
+        // w = w - velocity
+        Base::sweep(parameters, count, [parameters, &optimized, &rates, scale, decay, momentum]
+                                       (size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+            precision_type* velocity = optimized[p];
+
+            const precision_type rate = rates[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                velocity[i] = momentum * velocity[i] + rate * (scale * grad[i] + decay * param[i]);
+                param[i] -= velocity[i];
+            }
+        });
+    }
+};
+
+template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
+LARS<Net, TypeSet> LARSOptimizer(Net& net, Args&&... args)
+{
+    return LARS<Net, TypeSet>(net, std::forward<Args>(args)...);
+}
+
+} // namespace train
+
+namespace meta
+{
+
+template <typename T> struct is_lars_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_lars_optimizer<train::Optimizer<train::OptimizerType::lars, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
+} // namespace trixy
+
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_lars_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_lars_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_ & optimizer.momentum_ & optimizer.trust_;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_table_);
+    )
+SERIALIZABLE_INIT()
+
+#endif // TRIXY_OPTIMIZER_LARS_HPP
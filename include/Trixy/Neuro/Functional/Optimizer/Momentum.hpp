@@ -2,6 +2,7 @@
 #define TRIXY_OPTIMIZER_MOMENTUM_HPP
 
 #include <cstdint> // uintptr_t
+#include <vector> // vector
 
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
@@ -24,6 +25,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::momentum)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -33,6 +36,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
     using typename Base::RangeUnified;
 
 private:
@@ -44,6 +48,8 @@ private:
     Table buff_table_;
     Table optimized_table_;
 
+    std::vector<precision_type*> optimized_;  ///< states of the update_all() parameters
+
     precision_type learning_rate_;
     precision_type momentum_;
 
@@ -63,15 +69,7 @@ public:
 
     Optimizer& reset() noexcept
     {
-        auto first = optimized_table_.begin();
-        auto last  = optimized_table_.end();
-
-        while (first != last)
-        {
-            first->fill(0.);
-            ++first;
-        }
-
+        for (auto& state : optimized_table_) state.second.fill(0.);
         return *this;
     }
 
@@ -92,6 +90,32 @@ public:
 
         net.linear.add(param, optimized);
     }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_table_, parameters, count, optimized_);
+
+        const precision_type rate = learning_rate_ * Base::scale(parameters, count, alpha);
+        const precision_type shrink = Base::decay(learning_rate_);
+        const precision_type momentum = momentum_;
+
+        auto& optimized = optimized_;
+
+        // velocity = momentum * velocity - learning_rate * g
+        // w = shrink * w + velocity
+        Base::sweep(parameters, count, [parameters, &optimized, rate, shrink, momentum](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+            precision_type* velocity = optimized[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                velocity[i] = momentum * velocity[i] - rate * grad[i];
+                param[i] = shrink * param[i] + velocity[i];
+            }
+        });
+    }
 };
 
 template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
@@ -102,6 +126,28 @@ Momentum<Net, TypeSet> MomentumOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_momentum_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_momentum_optimizer<train::Optimizer<train::OptimizerType::momentum, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_momentum_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_momentum_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_ & optimizer.momentum_;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_table_);
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_MOMENTUM_HPP
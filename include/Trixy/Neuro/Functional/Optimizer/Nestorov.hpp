@@ -1,6 +1,8 @@
 #ifndef TRIXY_OPTIMIZER_NESTOROV_HPP
 #define TRIXY_OPTIMIZER_NESTOROV_HPP
 
+#include <vector> // vector
+
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
 
@@ -22,6 +24,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::nestorov)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -31,6 +35,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
     using typename Base::RangeUnified;
 
 private:
@@ -42,6 +47,8 @@ private:
     Table buff_table_;
     Table optimized_table_;
 
+    std::vector<precision_type*> optimized_;  ///< states of the update_all() parameters
+
     precision_type learning_rate_;
     precision_type momentum_;
 
@@ -61,15 +68,7 @@ public:
 
     Optimizer& reset() noexcept
     {
-        auto first = optimized_table_.begin();
-        auto last  = optimized_table_.end();
-
-        while (first != last)
-        {
-            first->fill(0.);
-            ++first;
-        }
-
+        for (auto& state : optimized_table_) state.second.fill(0.);
         return *this;
     }
 
@@ -92,6 +91,34 @@ public:
         net.linear.join(buff, momentum_, optimized);
         net.linear.add(param, buff);
     }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        Base::state(optimized_table_, parameters, count, optimized_);
+
+        const precision_type rate = learning_rate_ * Base::scale(parameters, count, alpha);
+        const precision_type shrink = Base::decay(learning_rate_);
+        const precision_type momentum = momentum_;
+
+        auto& optimized = optimized_;
+
+        // velocity = momentum * velocity - learning_rate * g
+        // w = shrink * w + momentum * velocity - learning_rate * g
+        Base::sweep(parameters, count, [parameters, &optimized, rate, shrink, momentum](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
+            precision_type* velocity = optimized[p];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const precision_type step = rate * grad[i];
+
+                velocity[i] = momentum * velocity[i] - step;
+                param[i] = shrink * param[i] + momentum * velocity[i] - step;
+            }
+        });
+    }
 };
 
 template <class TypeSet = OptimizerTypeSet, class Net, typename... Args>
@@ -102,6 +129,28 @@ Nestorov<Net, TypeSet> NestorovOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_nestorov_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_nestorov_optimizer<train::Optimizer<train::OptimizerType::nestorov, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_nestorov_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_nestorov_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_ & optimizer.momentum_;
+
+        S::archive_state(archive, optimizer.net, optimizer.optimized_table_);
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_NESTOROV_HPP
@@ -24,6 +24,8 @@ TRIXY_OPTIMIZER_TEMPLATE()
 class TRIXY_OPTIMIZER_TEMPLATE_CLASS(meta::is_trixy_net, OptimizerType::stograd_descent)
     : public IOptimizer<Optimizeriable>
 {
+    SERIALIZABLE_ACCESS()
+
 public:
     using Net  = Optimizeriable;
     using Base = IOptimizer<Net>;
@@ -33,6 +35,7 @@ public:
     using typename Base::size_type;
 
     using typename Base::Range;
+    using typename Base::Parameter;
 
 private:
     Net& net;
@@ -57,11 +60,31 @@ public:
 
     void update(Range param, Range grad) noexcept
     {
+        const Parameter parameter = { param.data(), grad.data(), static_cast<size_type>(param.size()) };
+
         // w = alpha * w - learning_rate * grad
-        net.linear.join(grad, learning_rate_);
-        net.linear.join(param, alpha_);
+        apply(&parameter, 1, learning_rate_, alpha_);
+    }
+
+    void update_all(const Parameter* parameters, size_type count, precision_type alpha)
+    {
+        const precision_type rate = learning_rate_ * Base::scale(parameters, count, alpha);
+        const precision_type shrink = alpha_ * Base::decay(learning_rate_);
+
+        // w = alpha * shrink * w - learning_rate * scale * grad
+        apply(parameters, count, rate, shrink);
+    }
+
+private:
+    static void apply(const Parameter* parameters, size_type count, precision_type rate, precision_type shrink)
+    {
+        Base::sweep(parameters, count, [parameters, rate, shrink](size_type p, size_type first, size_type last)
+        {
+            precision_type* param = parameters[p].param;
+            const precision_type* grad = parameters[p].grad;
 
-        net.linear.sub(param, grad);
+            for (size_type i = first; i < last; ++i) param[i] = shrink * param[i] - rate * grad[i];
+        });
     }
 };
 
@@ -73,6 +96,26 @@ StoGradDescent<Net, TypeSet> StoGradDescentOptimizer(Net& net, Args&&... args)
 
 } // namespace train
 
+namespace meta
+{
+
+template <typename T> struct is_stograd_descent_optimizer : std::false_type {};
+template <class Net, class TypeSet, typename enable>
+struct is_stograd_descent_optimizer<train::Optimizer<train::OptimizerType::stograd_descent, Net, TypeSet, enable>> : std::true_type {};
+
+} // namespace meta
+
 } // namespace trixy
 
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_stograd_descent_optimizer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, optimizer, trixy::meta::is_stograd_descent_optimizer<S>::value)
+    SERIALIZATION
+    (
+        archive & sf::base<typename S::Base>(optimizer)
+                & optimizer.learning_rate_ & optimizer.alpha_;
+    )
+SERIALIZABLE_INIT()
+
 #endif // TRIXY_OPTIMIZER_GRAD_DESCENT_HPP
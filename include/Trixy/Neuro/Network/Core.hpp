@@ -4,5 +4,8 @@
 #include <Trixy/Neuro/Network/Base.hpp>
 
 #include <Trixy/Neuro/Network/UnifiedNet.hpp>
+#include <Trixy/Neuro/Network/Quantizer.hpp>
+#include <Trixy/Neuro/Network/Pruner.hpp>
+#include <Trixy/Neuro/Network/Fuser.hpp>
 
 #endif // TRIXY_NETWORK_CORE_HPP
@@ -0,0 +1,56 @@
+#ifndef TRIXY_NETWORK_FUSER_HPP
+#define TRIXY_NETWORK_FUSER_HPP
+
+namespace trixy
+{
+
+// Fusion of the adjacent layers for inference: convolution with the next max pooling
+// (or pooling activation only), and fully connected layer without activation with the next one
+// if the folded weights aren't larger than weights of both.
+// Fused layer doesn't store the intermediate output, so it can't be trained
+template <class Fusible>
+class Fuser
+{
+public:
+    using Net = Fusible;
+
+    using ILayer                = typename Net::ILayer;
+    using size_type             = typename Net::size_type;
+
+private:
+    Net& net;
+
+public:
+    explicit Fuser(Net& network) : net(network) {}
+
+    // Return number of the fused pairs, fused layer is tried with the next one again
+    size_type fuse()
+    {
+        size_type count = 0;
+
+        for (size_type i = 0; i + 1 < net.size();)
+        {
+            ILayer* layer = net.layer(i).fuse(net.layer(i + 1));
+            if (layer == nullptr)
+            {
+                ++i;
+                continue;
+            }
+
+            ILayer* next = &net.layer(i + 1);
+
+            delete net.replace(i, layer);
+
+            net.remove(next);
+            delete next;
+
+            ++count;
+        }
+
+        return count;
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_NETWORK_FUSER_HPP
@@ -2,13 +2,17 @@
 #define TRIXY_NETWORK_LAYER_BASE_HPP
 
 #include <functional> // function
+#include <vector> // vector
 
 #include <Trixy/Base.hpp> // LayerType, LayerMode
 
 #include <Trixy/Serializer/Core.hpp>
+#include <Trixy/Random/Core.hpp>
 
 #include <Trixy/Neuro/Functional/Function/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
+#include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
+#include <Trixy/Neuro/Functional/Id.hpp>
 
 #include <Trixy/Detail/MacroScope.hpp>
 
@@ -32,17 +36,23 @@ public:
     using Matrix                = typename Net::Matrix;
     using Tensor                = typename Net::Tensor;
 
+    using VectorView            = typename Net::VectorView;
+    using MatrixView            = typename Net::MatrixView;
+    using TensorView            = typename Net::TensorView;
+
     using XVector               = typename Net::XVector;
     using XMatrix               = typename Net::XMatrix;
     using XTensor               = typename Net::XTensor;
 
     using size_type             = typename Net::size_type;
     using precision_type        = typename Net::precision_type;
+    using compute_type          = typename Net::compute_type;
     using shape_type            = typename Net::Tensor::shape_type;
 
     using Linear                = typename Net::Linear;
 
     using Generator             = std::function<precision_type()>; // type erasing
+    using InitializationId      = functional::InitializationId;
     using IActivation           = functional::activation::IActivation<precision_type>;
 
     using IOptimizer = train::IOptimizer<Net>;
@@ -50,14 +60,36 @@ public:
 public:
     virtual ~ILayer() = default;
 
-    virtual void init(Generator& generator) noexcept { /*pass*/ }
+    virtual void init(Generator& generator) { /*pass*/ }
+
+    // Bulk weights initialization from the own stream of the layer, biases are set to zero
+    virtual void init(InitializationId id, utility::Philox& generator) { /*pass*/ }
     virtual void connect(IActivation* activation) = 0;
 
     virtual void forward(const Tensor& input) noexcept = 0;
     virtual const Tensor& value() const noexcept = 0;
 
+    // Stateless forward, doesn't touch any layer cache, so it can be called from many threads at once.
+    // Output MUST be already allocated with osize() shape
+    virtual void forward(const Tensor& input, Tensor& output) const noexcept = 0;
+
     virtual const shape_type& isize() const noexcept = 0;
     virtual const shape_type& osize() const noexcept = 0;
+
+    // Return int8 form of the layer for the calibrated input scale, or nullptr if it has no such form.
+    // Activation is moved to the new layer, so this layer MUST be deleted after that
+    virtual ILayer* quantize(precision_type input_scale) { return nullptr; }
+
+    // Zero the smallest by magnitude weights, so that sparsity is a fraction of zeros in [0, 1].
+    // Layers with sparse form zero whole blocks of it
+    virtual void prune(double sparsity) { /*pass*/ }
+
+    // Return sparse form of the layer or nullptr, activation is moved as for quantize()
+    virtual ILayer* sparsify() { return nullptr; }
+
+    // Return single layer, which computes this and the next layer without their intermediate output,
+    // or nullptr. Activation of the next layer is moved, so both layers MUST be deleted after that
+    virtual ILayer* fuse(ILayer& next) { return nullptr; }
 };
 
 template <class Net>
@@ -73,21 +105,30 @@ public:
     using typename Base::Matrix;
     using typename Base::Tensor;
 
+    using typename Base::VectorView;
+    using typename Base::MatrixView;
+    using typename Base::TensorView;
+
     using typename Base::XVector;
     using typename Base::XMatrix;
     using typename Base::XTensor;
 
     using typename Base::size_type;
     using typename Base::precision_type;
+    using typename Base::compute_type;
     using typename Base::shape_type;
 
     using typename Base::Linear;
 
     using typename Base::Generator;
+    using typename Base::InitializationId;
     using typename Base::IActivation;
 
     using typename Base::IOptimizer;
 
+private:
+    std::vector<typename IOptimizer::Parameter> list_; ///< reusable list for the update()
+
 public:
     virtual ~ITrainLayer() = default;
 
@@ -95,10 +136,34 @@ public:
     virtual void backward(const Tensor& input, const Tensor& idelta, bool full = true) noexcept = 0;
     virtual const Tensor& delta() const noexcept = 0;
 
-    virtual void update(IOptimizer& optimizer, precision_type alpha) noexcept { /*pass*/ }
+    // One optimizer step over the parameters of this layer only: gradients are scaled, clipped and applied
+    // in one pass, so the step counter (Adam, LAMB) advances per call and clipping limits the norm of this layer.
+    // Training updates all layers by the single update_all() call, there step and norm are of the whole net
+    virtual void update(IOptimizer& optimizer, precision_type alpha)
+    {
+        list_.clear();
+        parameters(list_);
+
+        if (not list_.empty()) optimizer.update_all(list_.data(), list_.size(), alpha);
+
+        synchronize();
+    }
+
+    // Append trainable tensors with their gradients for the IOptimizer::update_all()
+    virtual void parameters(std::vector<typename IOptimizer::Parameter>& out) { /*pass*/ }
+
+    // Refresh the state derived from the trainable tensors, MUST be called after their update.
+    // Reduced precision copy is encoded in parallel there, so it isn't noexcept
+    virtual void synchronize() { /*pass*/ }
 
     virtual void accumulate() noexcept { /*pass*/ }
     virtual void reset() noexcept { /*pass*/ }
+
+    // Forward caches (value and what backward reads from the forward) for the gradient checkpointing:
+    // caches() appends their shapes, exchange() swaps them with tensors of these shapes in the same order.
+    // Training lends the planned buffers to the layer this way, so layers don't own caches while released
+    virtual void caches(std::vector<shape_type>& shapes) const { /*pass*/ }
+    virtual void exchange(Tensor* caches) noexcept { /*pass*/ }
 };
 
 } // namespace layer
@@ -112,6 +177,18 @@ template <class Net> struct is_ilayer<layer::ILayer<Net>> : std::true_type {};
 template <typename T> struct is_itrain_layer : std::false_type {};
 template <class Net> struct is_itrain_layer<layer::ITrainLayer<Net>> : std::true_type {};
 
+template <typename T> struct is_quantized_layer : std::false_type {};
+template <typename LayerType, class Net>
+struct is_quantized_layer<layer::Layer<LayerType, Net, LayerMode::Quantized>> : std::true_type {};
+
+template <typename T> struct is_sparse_layer : std::false_type {};
+template <typename LayerType, class Net>
+struct is_sparse_layer<layer::Layer<LayerType, Net, LayerMode::Sparse>> : std::true_type {};
+
+template <typename T> struct is_fused_layer : std::false_type {};
+template <typename LayerType, class Net>
+struct is_fused_layer<layer::Layer<LayerType, Net, LayerMode::Fused>> : std::true_type {};
+
 } // namespace meta
 
 } // namespace trixy
@@ -1,8 +1,17 @@
 #ifndef TRIXY_NETWORK_LAYER_CONVOLUTIONAL_HPP
 #define TRIXY_NETWORK_LAYER_CONVOLUTIONAL_HPP
 
+#include <cstdint> // uint8_t
+#include <limits> // numeric_limits
+#include <memory> // shared_ptr
+#include <utility> // swap
+
+#include <Trixy/Lique/Quantized.hpp>
+
 #include <Trixy/Neuro/Network/Layer/Base.hpp>
 #include <Trixy/Neuro/Network/Layer/Volume.hpp>
+#include <Trixy/Neuro/Network/Layer/MaxPooling.hpp>
+#include <Trixy/Neuro/Network/Layer/Detail/FunctionDetail.hpp>
 
 #include <Trixy/Neuro/Functional/Function/Activation.hpp>
 
@@ -22,6 +31,18 @@ using Convolutional = Layer<trixy::LayerType::Convolutional, Net, LayerMode>;
 template <class Net>
 using XConvolutional = Convolutional<Net, LayerMode::Raw>;
 
+template <class Net>
+using QConvolutional = Convolutional<Net, LayerMode::Quantized>;
+
+template <class Net>
+using FConvolutional = Convolutional<Net, LayerMode::Fused>;
+
+template <class Net>
+class Layer<trixy::LayerType::Convolutional, Net, LayerMode::Quantized>;
+
+template <class Net>
+class Layer<trixy::LayerType::Convolutional, Net, LayerMode::Fused>;
+
 template <class Net>
 class Layer<trixy::LayerType::Convolutional, Net, LayerMode::Raw>
     : public ILayer<Net>
@@ -37,8 +58,8 @@ protected:
     size_type vertical_stride_;
     size_type horizontal_stride_;
 
-    Vector B_;
-    Container<Tensor> Ws_;
+    VectorView B_;
+    Container<TensorView> Ws_;
 
 protected:
     // cache
@@ -47,6 +68,8 @@ protected:
 
     Tensor value_;
 
+    std::shared_ptr<void> storage_; ///< owns weights or keeps alive the mapped model
+
 public:
     Layer() {}
 
@@ -71,10 +94,16 @@ public:
         , vertical_stride_(vertical_stride)
         , horizontal_stride_(horizontal_stride)
     {
-        B_.resize(filter_count).fill(0.f);
+        auto filter_size = shape_type(size.depth, filter_height, filter_width);
+
+        storage_ = detail::allocate<precision_type>(filter_count * (1 + filter_size.size));
+
+        auto memory = static_cast<precision_type*>(storage_.get());
+
+        memory = detail::bind(B_, shape_type(filter_count), memory);
 
         Ws_.resize(filter_count);
-        for (auto& W : Ws_) W.resize(size.depth, filter_height, filter_width).fill(0.f);
+        for (auto& W : Ws_) memory = detail::bind(W, filter_size, memory);
 
         prepare();
     }
@@ -85,7 +114,25 @@ protected:
         filter_count_ = Ws_.size();
         filter_size_ = Ws_.front().shape();
 
-        value_.resize(osize_).fill(0.f);
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+    // Take ownership of the loaded weights, they are placed in the mapped model or allocated by archive
+    void attach()
+    {
+        auto scope = memory::MappingScope::current();
+        if (scope != nullptr)
+        {
+            storage_ = scope->keepalive();
+            return;
+        }
+
+        storage_ = detail::allocate<precision_type>(B_.size() + Ws_.size() * Ws_.front().size());
+
+        auto memory = static_cast<precision_type*>(storage_.get());
+
+        memory = detail::adopt(B_, memory);
+        for (auto& W : Ws_) memory = detail::adopt(W, memory);
     }
 
     void init(Generator& gen) noexcept override
@@ -94,9 +141,25 @@ protected:
         B_.fill(gen);
     }
 
+    void init(InitializationId id, utility::Philox& generator) override
+    {
+        // each output channel sees the filter window of all input channels
+        const size_type fan_in = filter_size_.size;
+        const size_type fan_out = filter_count_ * filter_size_.height * filter_size_.width;
+
+        for (auto& W : Ws_) detail::initialize(id, generator, W.data(), W.data() + W.size(), fan_in, fan_out);
+        B_.fill(0.f);
+    }
+
     void connect(IActivation* activation) override { /*pass*/ }
 
     void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
     {
         for (size_type f = 0; f < filter_count_; ++f)
         {
@@ -122,7 +185,7 @@ protected:
                         }
                     }
 
-                    value_(f, y, x) = sum;
+                    output(f, y, x) = sum;
                 }
             }
         }
@@ -132,6 +195,17 @@ protected:
 
     const shape_type& isize() const noexcept override { return isize_; }
     const shape_type& osize() const noexcept override { return osize_; }
+
+    ILayer<Net>* quantize(precision_type input_scale) override
+    {
+        return new QConvolutional<Net>(isize_, osize_, padding_, vertical_stride_, horizontal_stride_,
+                                       B_, Ws_, input_scale);
+    }
+
+    ILayer<Net>* fuse(ILayer<Net>& next) override
+    {
+        return FConvolutional<Net>::combine(*this, next);
+    }
 };
 
 template <class Net>
@@ -225,6 +299,8 @@ protected:
         buff_.resize(buff_size).fill(0.f);
     }
 
+    void attach() { /*pass*/ }
+
 public:
     void init(Generator& generation) noexcept override
     {
@@ -232,9 +308,24 @@ public:
         B_.fill(generation);
     }
 
+    void init(InitializationId id, utility::Philox& generator) override
+    {
+        // each output channel sees the filter window of all input channels
+        const size_type fan_in = filter_size_.size;
+        const size_type fan_out = filter_count_ * filter_size_.height * filter_size_.width;
+
+        for (auto& W : Ws_) detail::initialize(id, generator, W.data(), W.data() + W.size(), fan_in, fan_out);
+        B_.fill(0.f);
+    }
+
     void connect(IActivation* activation) override { /*pass*/ }
 
     void forward(const Tensor& input) noexcept override
+    {
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
     {
         for (size_type f = 0; f < filter_count_; ++f)
         {
@@ -260,7 +351,7 @@ public:
                         }
                     }
 
-                    value_(f, y, x) = sum;
+                    output(f, y, x) = sum;
                 }
             }
         }
@@ -334,13 +425,22 @@ public:
         }
     }
 
-    void update(IOptimizer& optimizer, precision_type alpha) noexcept override
+    void parameters(std::vector<typename IOptimizer::Parameter>& out) override
     {
-        for (auto& gradW : gradWs_) linear.join(gradW, alpha);
-        linear.join(gradB_, alpha);
+        for (size_type i = 0; i < Ws_.size(); ++i)
+            out.push_back({ Ws_[i].data(), gradWs_[i].data(), Ws_[i].size() });
 
-        for (size_type i = 0; i < Ws_.size(); ++i) optimizer.update(Ws_[i], gradWs_[i]);
-        optimizer.update(B_, gradB_);
+        out.push_back({ B_.data(), gradB_.data(), B_.size() });
+    }
+
+    void caches(std::vector<shape_type>& shapes) const override
+    {
+        shapes.push_back(osize_);
+    }
+
+    void exchange(Tensor* caches) noexcept override
+    {
+        std::swap(value_, caches[0]);
     }
 
     const Tensor& value() const noexcept override { return value_; }
@@ -348,6 +448,287 @@ public:
 
     const shape_type& isize() const noexcept override { return isize_; }
     const shape_type& osize() const noexcept override { return osize_; }
+
+    ILayer<Net>* quantize(precision_type input_scale) override
+    {
+        return new QConvolutional<Net>(isize_, osize_, padding_, vertical_stride_, horizontal_stride_,
+                                       B_, Ws_, input_scale);
+    }
+
+    ILayer<Net>* fuse(ILayer<Net>& next) override
+    {
+        return FConvolutional<Net>::combine(*this, next);
+    }
+};
+
+// Int8 filters with own scale for each of them, input is quantized by the calibrated scale.
+// Receptive field of each output position is gathered once and multiplied by all filters
+template <class Net>
+class Layer<trixy::LayerType::Convolutional, Net, LayerMode::Quantized>
+    : public ILayer<Net>
+{
+    TRIXY_LAYER_BODY(ILayer<Net>)
+
+protected:
+    shape_type isize_;
+    shape_type osize_;
+
+    size_type padding_;
+
+    size_type vertical_stride_;
+    size_type horizontal_stride_;
+
+    shape_type filter_size_;
+
+    Vector B_;
+    lique::QuantizedMatrix<precision_type> W_; ///< rows are filters
+
+    precision_type input_scale_;
+
+protected:
+    // cache
+    Tensor value_;
+
+public:
+    Layer() {}
+
+    template <class Bias, class Filters>
+    Layer(shape_type isize, shape_type osize,
+          size_type padding, size_type vertical_stride, size_type horizontal_stride,
+          const Bias& B, const Filters& Ws, precision_type input_scale)
+        : Base()
+        , isize_(isize)
+        , osize_(osize)
+        , padding_(padding)
+        , vertical_stride_(vertical_stride)
+        , horizontal_stride_(horizontal_stride)
+        , filter_size_(Ws.front().shape())
+        , input_scale_(input_scale)
+    {
+        B_.resize(Ws.size());
+        for (size_type f = 0; f < B_.size(); ++f) B_(f) = B(f);
+
+        W_.quantize(Ws.size(), filter_size_.size, [&Ws](size_type f, size_type i) { return Ws[f](i); });
+
+        prepare();
+    }
+
+protected:
+    void prepare()
+    {
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+public:
+    void connect(IActivation* activation) override { /*pass*/ }
+
+    void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        // quantized input and the receptive field in the layout of filter,
+        // tail of the field is multiplied by the zero padding of filters
+        auto x = W_.buffer(isize_.size + W_.stride());
+        auto field = x + isize_.size;
+
+        W_.quantize(input.data(), isize_.size, 1. / input_scale_, x);
+
+        for (size_type y = 0; y < osize_.height; ++y)
+        {
+            for (size_type x0 = 0; x0 < osize_.width; ++x0)
+            {
+                auto it = field;
+                for (size_type c = 0; c < filter_size_.depth; ++c)
+                {
+                    for (size_type i = 0; i < filter_size_.height; ++i)
+                    {
+                        for (size_type j = 0; j < filter_size_.width; ++j)
+                        {
+                            size_type i0 = vertical_stride_ * y + i - padding_;
+                            size_type j0 = horizontal_stride_ * x0 + j - padding_;
+
+                            // negative value will be bigger than bounds
+                            *it++ = i0 < isize_.height && j0 < isize_.width
+                                  ? x[(c * isize_.height + i0) * isize_.width + j0]
+                                  : static_cast<std::uint8_t>(W_.zero_point);
+                        }
+                    }
+                }
+
+                for (size_type f = 0; f < W_.height(); ++f)
+                    output(f, y, x0) = input_scale_ * W_.scale(f) * static_cast<precision_type>(W_.dot(f, field)) + B_(f);
+            }
+        }
+    }
+
+    precision_type input_scale() const noexcept { return input_scale_; }
+
+    const Tensor& value() const noexcept override { return value_; }
+
+    const shape_type& isize() const noexcept override { return isize_; }
+    const shape_type& osize() const noexcept override { return osize_; }
+};
+
+// Convolution with the next max pooling in the epilogue: each output is the max of the convolution
+// over the pooling window, so the convolution output is never stored. Pooling with 1x1 window
+// leaves only its activation, that is a convolution with activation
+template <class Net>
+class Layer<trixy::LayerType::Convolutional, Net, LayerMode::Fused>
+    : public ILayer<Net>
+{
+    TRIXY_LAYER_BODY(ILayer<Net>)
+
+protected:
+    shape_type isize_;
+    shape_type osize_;
+
+    size_type padding_;
+
+    size_type vertical_stride_;
+    size_type horizontal_stride_;
+
+    size_type vertical_pool_;
+    size_type horizontal_pool_;
+
+    shape_type filter_size_;
+
+    Vector B_;
+    Container<Tensor> Ws_;
+
+    IActivation* activation_;
+
+protected:
+    // cache
+    Tensor value_;
+
+public:
+    Layer() : activation_(nullptr) {}
+
+    template <class Convolution, class Pooling>
+    Layer(const Convolution& convolution, const Pooling& pooling, IActivation* activation)
+        : Base()
+        , isize_(convolution.isize_)
+        , osize_(pooling.osize_)
+        , padding_(convolution.padding_)
+        , vertical_stride_(convolution.vertical_stride_)
+        , horizontal_stride_(convolution.horizontal_stride_)
+        , vertical_pool_(pooling.vertical_stride_)
+        , horizontal_pool_(pooling.horizontal_stride_)
+        , filter_size_(convolution.filter_size_)
+        , activation_(activation)
+    {
+        B_.resize(convolution.B_.size());
+        for (size_type f = 0; f < B_.size(); ++f) B_(f) = convolution.B_(f);
+
+        Ws_.resize(convolution.Ws_.size());
+        for (size_type f = 0; f < Ws_.size(); ++f) Ws_[f].resize(filter_size_).copy(convolution.Ws_[f].data());
+
+        prepare();
+    }
+
+protected:
+    void prepare()
+    {
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+public:
+    virtual ~Layer() { delete activation_; }
+
+    void connect(IActivation* activation) override
+    {
+        delete activation_;
+        activation_ = activation;
+    }
+
+    void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        for (size_type f = 0; f < osize_.depth; ++f)
+        {
+            for (size_type y = 0; y < osize_.height; ++y)
+            {
+                for (size_type x = 0; x < osize_.width; ++x)
+                {
+                    const size_type y0 = y * vertical_pool_;
+                    const size_type x0 = x * horizontal_pool_;
+
+                    precision_type max = std::numeric_limits<precision_type>::lowest();
+
+                    for (size_type i = y0; i < y0 + vertical_pool_; ++i)
+                    {
+                        for (size_type j = x0; j < x0 + horizontal_pool_; ++j)
+                        {
+                            precision_type value = convolve(input, f, i, j);
+                            if (value > max) max = value;
+                        }
+                    }
+
+                    output(f, y, x) = max;
+                }
+            }
+        }
+
+        activation_->f(output, output);
+    }
+
+    const Tensor& value() const noexcept override { return value_; }
+
+    const shape_type& isize() const noexcept override { return isize_; }
+    const shape_type& osize() const noexcept override { return osize_; }
+
+    // Fuse the next max pooling layer into the convolution
+    template <class Convolution>
+    static ILayer<Net>* combine(Convolution& convolution, ILayer<Net>& next)
+    {
+        if (auto raw = dynamic_cast<XMaxPooling<Net>*>(&next)) return pool(convolution, *raw);
+        if (auto train = dynamic_cast<MaxPooling<Net>*>(&next)) return pool(convolution, *train);
+
+        return nullptr;
+    }
+
+private:
+    template <class Convolution, class Pooling>
+    static ILayer<Net>* pool(Convolution& convolution, Pooling& pooling)
+    {
+        auto layer = new FConvolutional<Net>(convolution, pooling, pooling.activation_);
+        pooling.activation_ = nullptr;
+
+        return layer;
+    }
+
+    // Convolution output of the filter f at (y, x)
+    precision_type convolve(const Tensor& input, size_type f, size_type y, size_type x) const noexcept
+    {
+        precision_type sum = B_(f);
+
+        for (size_type i = 0; i < filter_size_.height; ++i)
+        {
+            for (size_type j = 0; j < filter_size_.width; ++j)
+            {
+                size_type i0 = vertical_stride_ * y + i - padding_;
+                size_type j0 = horizontal_stride_ * x + j - padding_;
+
+                // negative value will be bigger than bounds
+                if (i0 >= isize_.height || j0 >= isize_.width)
+                    continue;
+
+                for (size_type c = 0; c < filter_size_.depth; ++c)
+                    sum += input(c, i0, j0) * Ws_[f](c, i, j);
+            }
+        }
+
+        return sum;
+    }
 };
 
 } // namespace layer
@@ -363,10 +744,14 @@ struct is_convolutional_layer<layer::Layer<LayerType::Convolutional, Net, LayerM
 
 } // namespace trixy
 
-CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_convolutional_layer<S>::value)
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_convolutional_layer<S>::value
+                                     and not trixy::meta::is_quantized_layer<S>::value
+                                     and not trixy::meta::is_fused_layer<S>::value)
 SERIALIZABLE_DECLARATION_INIT()
 
-CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_convolutional_layer<S>::value)
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_convolutional_layer<S>::value
+                                          and not trixy::meta::is_quantized_layer<S>::value
+                                          and not trixy::meta::is_fused_layer<S>::value)
     SERIALIZATION
     (
         archive & layer.isize_ & layer.osize_
@@ -374,6 +759,51 @@ CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_convolutional_layer<S>
                 & layer.vertical_stride_ & layer.horizontal_stride_
                 & layer.B_ & layer.Ws_;
 
+        if (trixy::meta::is_iarchive(archive))
+        {
+            layer.attach();
+            layer.prepare();
+        }
+    )
+SERIALIZABLE_INIT()
+
+// Quantized format: int8 filters with scales and the input scale instead of float filters
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_convolutional_layer<S>::value
+                                     and trixy::meta::is_quantized_layer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_convolutional_layer<S>::value
+                                          and trixy::meta::is_quantized_layer<S>::value)
+    SERIALIZATION
+    (
+        archive & layer.isize_ & layer.osize_
+                & layer.padding_
+                & layer.vertical_stride_ & layer.horizontal_stride_
+                & layer.filter_size_
+                & layer.B_ & layer.W_
+                & layer.input_scale_;
+
+        if (trixy::meta::is_iarchive(archive)) layer.prepare();
+    )
+SERIALIZABLE_INIT()
+
+// Fused format: convolution with the pooling window and activation
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_convolutional_layer<S>::value
+                                     and trixy::meta::is_fused_layer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_convolutional_layer<S>::value
+                                          and trixy::meta::is_fused_layer<S>::value)
+    SERIALIZATION
+    (
+        archive & layer.isize_ & layer.osize_
+                & layer.padding_
+                & layer.vertical_stride_ & layer.horizontal_stride_
+                & layer.vertical_pool_ & layer.horizontal_pool_
+                & layer.filter_size_
+                & layer.B_ & layer.Ws_
+                & layer.activation_;
+
         if (trixy::meta::is_iarchive(archive)) layer.prepare();
     )
 SERIALIZABLE_INIT()
@@ -1,6 +1,16 @@
 #ifndef TRIXY_NETWORK_LAYER_FUNCTION_DETAIL_HPP
 #define TRIXY_NETWORK_LAYER_FUNCTION_DETAIL_HPP
 
+#include <algorithm> // sort, min
+#include <cmath> // sqrt
+#include <cstddef> // size_t
+#include <memory> // shared_ptr, default_delete
+#include <vector> // vector
+
+#include <Trixy/Lique/Detail/FunctionDetail.hpp>
+
+#include <Trixy/Neuro/Functional/Id.hpp>
+
 #include <Trixy/Detail/TrixyMeta.hpp>
 #include <Trixy/Lique/Detail/LiqueMeta.hpp>
 
@@ -9,12 +19,125 @@
 namespace trixy
 {
 
-namespace utility
+namespace layer
+{
+
+namespace detail
+{
+
+// Zero initialized weights storage for the view tensors of the layer
+template <typename Precision>
+std::shared_ptr<void> allocate(std::size_t size)
+{
+    return std::shared_ptr<Precision>(new Precision [size](), std::default_delete<Precision[]>());
+}
+
+// Point view tensor to the memory and return the next free place
+template <class View, class Shape, typename Pointer>
+Pointer bind(View& view, const Shape& shape, Pointer memory) noexcept
+{
+    view = View(shape, memory);
+    return memory + view.size();
+}
+
+// Move data of the view tensor, which was allocated by archive, to the memory
+template <class View, typename Pointer>
+Pointer adopt(View& view, Pointer memory) noexcept
+{
+    auto data = view.data();
+
+    lique::detail::copy(memory, memory + view.size(), data);
+    delete[] data;
+
+    return bind(view, view.shape(), memory);
+}
+
+// Fill weights [first, last) by the fan-in/fan-out aware scheme
+template <typename Precision, class Generator>
+void initialize(functional::InitializationId id, Generator& generator,
+                Precision* first, Precision* last, std::size_t fan_in, std::size_t fan_out)
+{
+    using functional::InitializationId;
+
+    const double in = static_cast<double>(fan_in > 0 ? fan_in : 1);
+    const double average = 0.5 * (in + static_cast<double>(fan_out > 0 ? fan_out : 1));
+
+    double limit = 0.;
+    double std = 0.;
+
+    switch (id)
+    {
+    case InitializationId::he_uniform:      limit = std::sqrt(6. / in); break;
+    case InitializationId::he_normal:       std = std::sqrt(2. / in); break;
+    case InitializationId::xavier_uniform:  limit = std::sqrt(3. / average); break;
+    case InitializationId::xavier_normal:   std = std::sqrt(1. / average); break;
+    case InitializationId::lecun_uniform:   limit = std::sqrt(3. / in); break;
+    case InitializationId::lecun_normal:    std = std::sqrt(1. / in); break;
+    default: return;
+    }
+
+    if (limit > 0.)
+        generator.fill(first, last, static_cast<Precision>(-limit), static_cast<Precision>(limit));
+    else
+        generator.normal(first, last, Precision(0), static_cast<Precision>(std));
+}
+
+// Zero the smallest blocks of height x width row-major weights, so that sparsity is a fraction of zeros in [0, 1].
+// Each block holds block consecutive values of one row, the last block of a row is shorter if width isn't
+// divisible by block. Blocks are ranked by the mean square, block = 1 gives unstructured magnitude pruning
+template <typename Precision>
+void prune(Precision* data, std::size_t height, std::size_t width, std::size_t block, double sparsity)
 {
+    const std::size_t size = height * width;
+
+    std::size_t count = sparsity > 0. ? static_cast<std::size_t>(sparsity * static_cast<double>(size)) : 0;
+    if (count > size) count = size;
+
+    if (count == 0) return;
+
+    const std::size_t row_blocks = (width + block - 1) / block;
+
+    std::vector<double> norms(height * row_blocks);
+    for (std::size_t i = 0; i < height; ++i)
+    {
+        for (std::size_t b = 0; b < row_blocks; ++b)
+        {
+            const std::size_t first = b * block;
+            const std::size_t last = std::min(first + block, width);
+
+            double norm = 0.;
+            for (std::size_t j = first; j < last; ++j)
+                norm += static_cast<double>(data[i * width + j]) * static_cast<double>(data[i * width + j]);
+
+            norms[i * row_blocks + b] = norm / static_cast<double>(last - first);
+        }
+    }
+
+    std::vector<std::size_t> order(norms.size());
+    for (std::size_t n = 0; n < order.size(); ++n) order[n] = n;
+
+    std::sort(order.begin(), order.end(), [&norms](std::size_t lhs, std::size_t rhs)
+    {
+        return norms[lhs] < norms[rhs];
+    });
+
+    // whole blocks are zeroed, so the last one may exceed the count by less than the block
+    std::size_t zeroed = 0;
+    for (std::size_t n = 0; n < order.size() && zeroed < count; ++n)
+    {
+        const std::size_t i = order[n] / row_blocks;
+        const std::size_t first = order[n] % row_blocks * block;
+        const std::size_t last = std::min(first + block, width);
+
+        for (std::size_t j = first; j < last; ++j) data[i * width + j] = 0.;
+
+        zeroed += last - first;
+    }
+}
 
-// impl here <--
+} // namespace detail
 
-} // namespace utility
+} // namespace layer
 
 } // namespace trixy
 
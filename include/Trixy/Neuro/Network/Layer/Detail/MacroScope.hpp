@@ -5,6 +5,7 @@
 
 #define TRIXY_LAYER_BODY(...)                                                                           \
     SERIALIZABLE_ACCESS()                                                                              \
+    template <typename, class, typename> friend class Layer; /*layers are rewritten by each other*/     \
     public:                                                                                             \
         using Base = __VA_ARGS__;                                                                       \
         using typename Base::IOptimizer;                                                                \
@@ -16,6 +17,10 @@
         using typename Base::Matrix;                                                                    \
         using typename Base::Tensor;                                                                    \
                                                                                                         \
+        using typename Base::VectorView;                                                                \
+        using typename Base::MatrixView;                                                                \
+        using typename Base::TensorView;                                                                \
+                                                                                                        \
         using typename Base::XVector;                                                                   \
         using typename Base::XMatrix;                                                                   \
         using typename Base::XTensor;                                                                   \
@@ -24,9 +29,11 @@
                                                                                                         \
         using typename Base::size_type;                                                                 \
         using typename Base::precision_type;                                                            \
+        using typename Base::compute_type;                                                              \
         using typename Base::shape_type;                                                                \
                                                                                                         \
         using typename Base::Generator;                                                                 \
+        using typename Base::InitializationId;                                                          \
         using typename Base::IActivation;                                                               \
                                                                                                         \
     public:                                                                                             \
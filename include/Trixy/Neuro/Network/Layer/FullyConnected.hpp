@@ -1,8 +1,18 @@
 #ifndef TRIXY_NETWORK_LAYER_FULLY_CONNECTED_HPP
 #define TRIXY_NETWORK_LAYER_FULLY_CONNECTED_HPP
 
+#include <cstdint> // uint8_t
+#include <memory> // shared_ptr
+#include <utility> // swap
+#include <vector> // vector
+
+#include <Trixy/Lique/Reduced.hpp>
+#include <Trixy/Lique/Quantized.hpp>
+#include <Trixy/Lique/Sparse.hpp>
+
 #include <Trixy/Neuro/Network/Layer/Base.hpp>
 #include <Trixy/Neuro/Network/Layer/Volume.hpp>
+#include <Trixy/Neuro/Network/Layer/Detail/FunctionDetail.hpp>
 
 #include <Trixy/Neuro/Functional/Function/Activation.hpp>
 
@@ -23,6 +33,18 @@ using FullyConnected = Layer<trixy::LayerType::FullyConnected, Net, LayerMode>;
 template <class Net>
 using XFullyConnected = FullyConnected<Net, LayerMode::Raw>;
 
+template <class Net>
+using QFullyConnected = FullyConnected<Net, LayerMode::Quantized>;
+
+template <class Net>
+using SFullyConnected = FullyConnected<Net, LayerMode::Sparse>;
+
+template <class Net>
+class Layer<trixy::LayerType::FullyConnected, Net, LayerMode::Quantized>;
+
+template <class Net>
+class Layer<trixy::LayerType::FullyConnected, Net, LayerMode::Sparse>;
+
 template <class Net>
 class Layer<trixy::LayerType::FullyConnected, Net, LayerMode::Raw>
     : public ILayer<Net>
@@ -33,8 +55,8 @@ protected:
     shape_type isize_;
     shape_type osize_;
 
-    Vector B_;
-    Matrix W_;
+    VectorView B_;
+    MatrixView W_;
 
     IActivation* activation_;
 
@@ -42,6 +64,8 @@ protected:
     // cache
     Tensor value_;
 
+    std::shared_ptr<void> storage_; ///< owns weights or keeps alive the mapped model
+
 public:
     Linear linear;
 
@@ -58,8 +82,12 @@ public:
         , isize_(1, 1, isize), osize_(1, 1, osize)
         , activation_(activation)
     {
-        B_.resize(osize).fill(0.f);
-        W_.resize(isize, osize).fll(0.f);
+        storage_ = detail::allocate<precision_type>(osize + isize * osize);
+
+        auto memory = static_cast<precision_type*>(storage_.get());
+
+        memory = detail::bind(B_, shape_type(osize), memory);
+        memory = detail::bind(W_, shape_type(isize, osize), memory);
 
         prepare();
     }
@@ -67,7 +95,25 @@ public:
 protected:
     void prepare()
     {
-        value_.resize(osize_).fill(0.f);
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+    // Take ownership of the loaded weights, they are placed in the mapped model or allocated by archive
+    void attach()
+    {
+        auto scope = memory::MappingScope::current();
+        if (scope != nullptr)
+        {
+            storage_ = scope->keepalive();
+            return;
+        }
+
+        storage_ = detail::allocate<precision_type>(B_.size() + W_.size());
+
+        auto memory = static_cast<precision_type*>(storage_.get());
+
+        memory = detail::adopt(B_, memory);
+        memory = detail::adopt(W_, memory);
     }
 
 public:
@@ -80,22 +126,90 @@ public:
     }
 
     void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
     {
         // H - input
         // S - buff
 
         // S = H . W + B
-        linear.dot(value_, input, W_);
-        linear.add(value_, B_);
+        linear.dot(output, input, W_);
+        linear.add(output, B_);
 
         // value = F(S)
-        activation_->f(value_, value_);
+        activation_->f(output, output);
     }
 
     const Tensor& value() const noexcept override { return value_; }
 
     const shape_type& isize() const noexcept override { return isize_; }
     const shape_type& osize() const noexcept override { return osize_; }
+
+    ILayer<Net>* quantize(precision_type input_scale) override
+    {
+        auto layer = new QFullyConnected<Net>(B_, W_, input_scale, activation_);
+        activation_ = nullptr;
+
+        return layer;
+    }
+
+    void prune(double sparsity) override
+    {
+        // blocks of the sparse form are 4 outputs of one input, that is 4 consecutive values of W row
+        detail::prune(W_.data(), isize_.size, osize_.size, lique::SparseMatrix<precision_type>::block, sparsity);
+    }
+
+    ILayer<Net>* sparsify() override
+    {
+        auto layer = new SFullyConnected<Net>(B_, W_, activation_);
+        activation_ = nullptr;
+
+        return layer;
+    }
+
+    ILayer<Net>* fuse(ILayer<Net>& next) override
+    {
+        return combine(*this, next);
+    }
+
+    // Fold the next fully connected layer into the first one, if the first has no activation:
+    // (H . W1 + B1) . W2 + B2 = H . (W1 . W2) + (B1 . W2 + B2).
+    // Bottleneck (e.g. 1024 -> 16 -> 1024) isn't folded, its dense product would be larger than both
+    template <class First>
+    static ILayer<Net>* combine(First& first, ILayer<Net>& next)
+    {
+        if (dynamic_cast<Identity*>(first.activation_) == nullptr) return nullptr;
+
+        if (auto raw = dynamic_cast<XFullyConnected<Net>*>(&next)) return fold(first, *raw);
+        if (auto train = dynamic_cast<FullyConnected<Net>*>(&next)) return fold(first, *train);
+
+        return nullptr;
+    }
+
+private:
+    template <class First, class Next>
+    static ILayer<Net>* fold(First& first, Next& next)
+    {
+        const size_type isize = first.isize_.size;
+        const size_type hidden = first.osize_.size;
+        const size_type osize = next.osize_.size;
+
+        if (isize * osize > hidden * (isize + osize)) return nullptr;
+
+        auto layer = new XFullyConnected<Net>(first.isize_.size, next.osize_.size, next.activation_);
+        next.activation_ = nullptr;
+
+        layer->linear.dot(layer->W_, first.W_, next.W_);
+
+        layer->linear.dot(layer->B_, first.B_, next.W_);
+        layer->linear.add(layer->B_, next.B_);
+
+        return layer;
+    }
 };
 
 template <class Net>
@@ -115,8 +229,10 @@ protected:
 
 protected:
     // cache
+    lique::ReducedMatrix<precision_type, compute_type> computeW_; ///< W in the compute precision
+
     Tensor value_;
-    Vector buff_;
+    Tensor buff_;
 
     Vector gradB_;
     Matrix gradW_;
@@ -126,6 +242,8 @@ protected:
 
     Tensor delta_;
 
+    std::vector<std::uint8_t> mask_; ///< zero for pruned weights, empty if layer isn't pruned
+
     bool accumulated_;
 
 public:
@@ -162,15 +280,32 @@ protected:
         gradW_.resize(isize_.width, osize_.width).fill(0.f);
         delta_.resize(isize_).fill(0.f);
         accumulated_ = false;
+
+        mask_.clear();
+        computeW_.copy(W_);
     }
 
+    void attach() { /*pass*/ }
+
 public:
     virtual ~Layer() { delete activation_; }
 
-    void init(Generator& generation) noexcept override
+    void init(Generator& generation) override
     {
         B_.fill(generation);
         W_.fill(generation);
+
+        mask_.clear();
+        computeW_.copy(W_);
+    }
+
+    void init(InitializationId id, utility::Philox& generator) override
+    {
+        B_.fill(0.f);
+        detail::initialize(id, generator, W_.data(), W_.data() + W_.size(), isize_.size, osize_.size);
+
+        mask_.clear();
+        computeW_.copy(W_);
     }
 
     void connect(IActivation* activation) override
@@ -186,13 +321,21 @@ public:
 
         // S = H . W + B
 
-        linear.dot(buff_, input, W_);
+        computeW_.dot(buff_, input, W_);
         linear.add(buff_, B_);
 
         // value = F(S)
         activation_->f(value_, buff_);
     }
 
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        computeW_.dot(output, input, W_);
+        linear.add(output, B_);
+
+        activation_->f(output, output);
+    }
+
     void backward(const Tensor& input, const Tensor& idelta, bool full = true) noexcept override
     {
         // curr_delta  - gradB
@@ -211,22 +354,24 @@ public:
         // curr_delta - gradB
         // delta = curr_delta . W^T
 
-        if (full) linear.dot(delta_, W_, gradB_);
+        if (full) computeW_.dot(delta_, W_, gradB_);
     }
 
-    void update(IOptimizer& optimizer, precision_type alpha) noexcept override
+    void parameters(std::vector<typename IOptimizer::Parameter>& out) override
     {
         auto& gradB = accumulated_ ? gradBs_ : gradB_;
         auto& gradW = accumulated_ ? gradWs_ : gradW_;
 
-        if (alpha != 1.f)
-        {
-            linear.join(gradB, alpha);
-            linear.join(gradW, alpha);
-        }
+        out.push_back({ B_.data(), gradB.data(), B_.size() });
+        out.push_back({ W_.data(), gradW.data(), W_.size() });
+    }
 
-        optimizer.update(B_, gradB);
-        optimizer.update(W_, gradW);
+    void synchronize() override
+    {
+        for (size_type i = 0; i < mask_.size(); ++i)
+            if (mask_[i] == 0) W_.data()[i] = 0.;
+
+        computeW_.copy(W_);
     }
 
     void reset() noexcept override
@@ -237,6 +382,18 @@ public:
         accumulated_ = false;
     }
 
+    void caches(std::vector<shape_type>& shapes) const override
+    {
+        shapes.push_back(osize_);
+        shapes.push_back(osize_);
+    }
+
+    void exchange(Tensor* caches) noexcept override
+    {
+        std::swap(value_, caches[0]);
+        std::swap(buff_, caches[1]);
+    }
+
     void accumulate() noexcept override
     {
         linear.add(gradBs_, gradB_);
@@ -250,6 +407,200 @@ public:
 
     const shape_type& isize() const noexcept override { return isize_; }
     const shape_type& osize() const noexcept override { return osize_; }
+
+    ILayer<Net>* quantize(precision_type input_scale) override
+    {
+        auto layer = new QFullyConnected<Net>(B_, W_, input_scale, activation_);
+        activation_ = nullptr;
+
+        return layer;
+    }
+
+    // Pruned blocks stay zero during the next training, init() resets the pruning
+    void prune(double sparsity) override
+    {
+        detail::prune(W_.data(), isize_.size, osize_.size, lique::SparseMatrix<precision_type>::block, sparsity);
+
+        mask_.resize(W_.size());
+        for (size_type i = 0; i < W_.size(); ++i) mask_[i] = W_.data()[i] != 0.;
+
+        computeW_.copy(W_);
+    }
+
+    ILayer<Net>* sparsify() override
+    {
+        auto layer = new SFullyConnected<Net>(B_, W_, activation_);
+        activation_ = nullptr;
+
+        return layer;
+    }
+
+    ILayer<Net>* fuse(ILayer<Net>& next) override
+    {
+        return XFullyConnected<Net>::combine(*this, next);
+    }
+};
+
+// Int8 weights with own scale for each output neuron, input is quantized by the calibrated scale.
+// Products are accumulated in int32, dequantization is fused with bias and activation
+template <class Net>
+class Layer<trixy::LayerType::FullyConnected, Net, LayerMode::Quantized>
+    : public ILayer<Net>
+{
+    TRIXY_LAYER_BODY(ILayer<Net>)
+
+protected:
+    shape_type isize_;
+    shape_type osize_;
+
+    Vector B_;
+    lique::QuantizedMatrix<precision_type> W_; ///< rows are output neurons
+
+    precision_type input_scale_;
+
+    IActivation* activation_;
+
+protected:
+    // cache
+    Tensor value_;
+
+public:
+    Layer() : activation_(nullptr) {}
+
+    // W has isize x osize shape, input_scale is a quantization step of the input
+    template <class Bias, class Weight>
+    Layer(const Bias& B, const Weight& W, precision_type input_scale, IActivation* activation = new Identity)
+        : Base()
+        , isize_(1, 1, W.shape().height), osize_(1, 1, W.shape().width)
+        , input_scale_(input_scale)
+        , activation_(activation)
+    {
+        B_.resize(osize_.size);
+        for (size_type j = 0; j < B_.size(); ++j) B_(j) = B(j);
+
+        W_.quantize(osize_.size, isize_.size, [&W](size_type i, size_type j) { return W(j, i); });
+
+        prepare();
+    }
+
+protected:
+    void prepare()
+    {
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+public:
+    virtual ~Layer() { delete activation_; }
+
+    void connect(IActivation* activation) override
+    {
+        delete activation_;
+        activation_ = activation;
+    }
+
+    void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        auto x = W_.buffer(W_.stride());
+        W_.quantize(input.data(), isize_.size, 1. / input_scale_, x);
+
+        // S = input_scale * scale * (Hq . Wq) + B
+        for (size_type j = 0; j < osize_.size; ++j)
+            output(j) = input_scale_ * W_.scale(j) * static_cast<precision_type>(W_.dot(j, x)) + B_(j);
+
+        activation_->f(output, output);
+    }
+
+    precision_type input_scale() const noexcept { return input_scale_; }
+
+    const Tensor& value() const noexcept override { return value_; }
+
+    const shape_type& isize() const noexcept override { return isize_; }
+    const shape_type& osize() const noexcept override { return osize_; }
+};
+
+// Weights are kept in 4x1 block sparse rows, so only the stored blocks are read in the forward
+template <class Net>
+class Layer<trixy::LayerType::FullyConnected, Net, LayerMode::Sparse>
+    : public ILayer<Net>
+{
+    TRIXY_LAYER_BODY(ILayer<Net>)
+
+protected:
+    shape_type isize_;
+    shape_type osize_;
+
+    Vector B_;
+    lique::SparseMatrix<precision_type> W_; ///< rows are output neurons
+
+    IActivation* activation_;
+
+protected:
+    // cache
+    Tensor value_;
+
+public:
+    Layer() : activation_(nullptr) {}
+
+    // W has isize x osize shape, zero weights are dropped
+    template <class Bias, class Weight>
+    Layer(const Bias& B, const Weight& W, IActivation* activation = new Identity)
+        : Base()
+        , isize_(1, 1, W.shape().height), osize_(1, 1, W.shape().width)
+        , activation_(activation)
+    {
+        B_.resize(osize_.size);
+        for (size_type j = 0; j < B_.size(); ++j) B_(j) = B(j);
+
+        W_.compress(osize_.size, isize_.size, [&W](size_type i, size_type j) { return W(j, i); });
+
+        prepare();
+    }
+
+protected:
+    void prepare()
+    {
+        value_ = Tensor(); // allocated by the first forward
+    }
+
+public:
+    virtual ~Layer() { delete activation_; }
+
+    void connect(IActivation* activation) override
+    {
+        delete activation_;
+        activation_ = activation;
+    }
+
+    void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        // S = W^T . H + B
+        W_.dot(output.data(), input.data());
+        linear.add(output, B_);
+
+        activation_->f(output, output);
+    }
+
+    double sparsity() const noexcept { return W_.sparsity(); }
+
+    const Tensor& value() const noexcept override { return value_; }
+
+    const shape_type& isize() const noexcept override { return isize_; }
+    const shape_type& osize() const noexcept override { return osize_; }
+
+public:
+    Linear linear;
 };
 
 } // namespace layer
@@ -265,16 +616,59 @@ struct is_fully_connected_layer<layer::Layer<LayerType::FullyConnected, Net, Lay
 
 } // namespace trixy
 
-CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_fully_connected_layer<S>::value)
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_fully_connected_layer<S>::value
+                                     and not trixy::meta::is_quantized_layer<S>::value
+                                     and not trixy::meta::is_sparse_layer<S>::value)
 SERIALIZABLE_DECLARATION_INIT()
 
-CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_fully_connected_layer<S>::value)
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_fully_connected_layer<S>::value
+                                          and not trixy::meta::is_quantized_layer<S>::value
+                                          and not trixy::meta::is_sparse_layer<S>::value)
     SERIALIZATION
     (
         archive & layer.isize_ & layer.osize_
             & layer.B_ & layer.W_
             & layer.activation_;
 
+        if (trixy::meta::is_iarchive(archive))
+        {
+            layer.attach();
+            layer.prepare();
+        }
+    )
+SERIALIZABLE_INIT()
+
+// Quantized format: int8 rows with scales and the input scale instead of float weights
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_fully_connected_layer<S>::value
+                                     and trixy::meta::is_quantized_layer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_fully_connected_layer<S>::value
+                                          and trixy::meta::is_quantized_layer<S>::value)
+    SERIALIZATION
+    (
+        archive & layer.isize_ & layer.osize_
+                & layer.B_ & layer.W_
+                & layer.input_scale_
+                & layer.activation_;
+
+        if (trixy::meta::is_iarchive(archive)) layer.prepare();
+    )
+SERIALIZABLE_INIT()
+
+// Sparse format: block sparse rows instead of dense weights
+CONDITIONAL_SERIALIZABLE_DECLARATION(trixy::meta::is_fully_connected_layer<S>::value
+                                     and trixy::meta::is_sparse_layer<S>::value)
+SERIALIZABLE_DECLARATION_INIT()
+
+CONDITIONAL_SERIALIZABLE(saveload, layer, trixy::meta::is_fully_connected_layer<S>::value
+                                          and trixy::meta::is_sparse_layer<S>::value)
+    SERIALIZATION
+    (
+        archive & layer.isize_ & layer.osize_
+                & layer.B_ & layer.W_
+                & layer.activation_;
+
         if (trixy::meta::is_iarchive(archive)) layer.prepare();
     )
 SERIALIZABLE_INIT()
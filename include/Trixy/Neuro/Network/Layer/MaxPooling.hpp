@@ -1,6 +1,9 @@
 #ifndef TRIXY_NETWORK_LAYER_MAX_POOLING_HPP
 #define TRIXY_NETWORK_LAYER_MAX_POOLING_HPP
 
+#include <utility> // swap
+#include <vector> // vector
+
 #include <Trixy/Neuro/Network/Layer/Base.hpp>
 #include <Trixy/Neuro/Network/Layer/Volume.hpp>
 
@@ -72,13 +75,14 @@ public:
         , horizontal_stride_(horizontal_stride)
         , activation_(activation)
     {
-        value_.resize(osize_).fill(0.f);
-
         prepare();
     }
 
 protected:
-    void prepare() { /*pass*/ }
+    void prepare()
+    {
+        value_ = Tensor(); // allocated by the first forward
+    }
 
 public:
     virtual ~Layer() { delete activation_; }
@@ -90,6 +94,12 @@ public:
     }
 
     void forward(const Tensor& input) noexcept override
+    {
+        if (value_.size() != osize_.size) value_.resize(osize_);
+        forward(input, value_);
+    }
+
+    void forward(const Tensor& input, Tensor& output) const noexcept override
     {
         for (size_type d = 0; d < isize_.depth; ++d)
         {
@@ -108,12 +118,12 @@ public:
                         }
                     }
 
-                    value_(d, i / vertical_stride_, j / horizontal_stride_) = max;
+                    output(d, i / vertical_stride_, j / horizontal_stride_) = max;
                 }
             }
         }
 
-        activation_->f(value_, value_);
+        activation_->f(output, output);
     }
 
     const Tensor& value() const noexcept override { return value_; }
@@ -174,14 +184,13 @@ public:
         , horizontal_stride_(horizontal_stride)
         , activation_(activation)
     {
-        value_.resize(osize_).fill(0.f);
-
         prepare();
     }
 
 protected:
     void prepare()
     {
+        value_.resize(osize_).fill(0.f);
         delta_.resize(isize_).fill(0.f);
         mask_.resize(isize_).fill(0.f);
         buff_.resize(osize_).fill(0.f);
@@ -229,7 +238,7 @@ public:
                         }
                     }
 
-                    value_(d, i / vertical_stride_, j / horizontal_stride_) = max;
+                    buff_(d, i / vertical_stride_, j / horizontal_stride_) = max;
                     mask_(d, imax, jmax) = 1.f;
                 }
             }
@@ -238,6 +247,33 @@ public:
         activation_->f(value_, buff_);
     }
 
+    void forward(const Tensor& input, Tensor& output) const noexcept override
+    {
+        for (size_type d = 0; d < isize_.depth; ++d)
+        {
+            for (size_type i = 0; i < isize_.height; i += vertical_stride_)
+            {
+                for (size_type j = 0; j < isize_.width; j += horizontal_stride_)
+                {
+                    precision_type max = input(d, i, j);
+
+                    for (size_type y = i; y < i + vertical_stride_; ++y)
+                    {
+                        for (size_type x = j; x < j + horizontal_stride_; ++x)
+                        {
+                            precision_type value = input(d, y, x);
+                            if (value > max) max = value;
+                        }
+                    }
+
+                    output(d, i / vertical_stride_, j / horizontal_stride_) = max;
+                }
+            }
+        }
+
+        activation_->f(output, output);
+    }
+
     void backward(const Tensor& /*input*/, const Tensor& idelta, bool full = true/*unused*/) noexcept override
     {
         activation_->df(buff_, buff_);
@@ -249,6 +285,20 @@ public:
                     delta_(d, i, j) = buff_(d, i / vertical_stride_, j / horizontal_stride_) * mask_(d, i, j);
     }
 
+    void caches(std::vector<shape_type>& shapes) const override
+    {
+        shapes.push_back(osize_);
+        shapes.push_back(isize_);
+        shapes.push_back(osize_);
+    }
+
+    void exchange(Tensor* caches) noexcept override
+    {
+        std::swap(value_, caches[0]);
+        std::swap(mask_, caches[1]);
+        std::swap(buff_, caches[2]);
+    }
+
     const Tensor& value() const noexcept override { return value_; }
     const Tensor& delta() const noexcept override { return delta_; }
 
@@ -0,0 +1,51 @@
+#ifndef TRIXY_NETWORK_PRUNER_HPP
+#define TRIXY_NETWORK_PRUNER_HPP
+
+namespace trixy
+{
+
+// Magnitude pruning of the network.
+// prune() zeroes the smallest weights of each layer up to the sparsity fraction, by whole blocks of the sparse form,
+// sparsify() replaces each layer, which has the sparse form, by it
+template <class Prunable>
+class Pruner
+{
+public:
+    using Net = Prunable;
+
+    using ILayer                = typename Net::ILayer;
+    using size_type             = typename Net::size_type;
+
+private:
+    Net& net;
+
+public:
+    explicit Pruner(Net& network) : net(network) {}
+
+    void prune(double sparsity)
+    {
+        for (size_type l = 0; l < net.size(); ++l)
+            net.layer(l).prune(sparsity);
+    }
+
+    // Return number of the replaced layers
+    size_type sparsify()
+    {
+        size_type count = 0;
+
+        for (size_type l = 0; l < net.size(); ++l)
+        {
+            ILayer* layer = net.layer(l).sparsify();
+            if (layer == nullptr) continue;
+
+            delete net.replace(l, layer);
+            ++count;
+        }
+
+        return count;
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_NETWORK_PRUNER_HPP
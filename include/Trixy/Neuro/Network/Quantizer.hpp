@@ -0,0 +1,102 @@
+#ifndef TRIXY_NETWORK_QUANTIZER_HPP
+#define TRIXY_NETWORK_QUANTIZER_HPP
+
+#include <cmath> // fabs
+#include <vector> // vector
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+
+namespace trixy
+{
+
+// Post-training int8 quantization of the network.
+// calibrate() tracks the largest absolute input of each layer over the sample dataset by the float forward,
+// quantize() replaces each layer, which has the int8 form, by it with the input scale max / 127
+template <class Quantizable>
+class Quantizer
+{
+public:
+    using Net = Quantizable;
+
+    template <typename T>
+    using Container             = typename Net::template Container<T>;
+
+    using Tensor                = typename Net::Tensor;
+    using ILayer                = typename Net::ILayer;
+
+    using precision_type        = typename Net::precision_type;
+    using size_type             = typename Net::size_type;
+
+private:
+    static constexpr size_type calibrate_per_thread = 32; ///< min number of samples per thread
+
+private:
+    Net& net;
+
+    std::vector<precision_type> ranges_; ///< max absolute input of each layer
+
+public:
+    explicit Quantizer(Net& network) : net(network), ranges_(network.size(), precision_type(0.)) {}
+
+    const std::vector<precision_type>& ranges() const noexcept { return ranges_; }
+
+    // Can be called several times, ranges are accumulated
+    void calibrate(const Container<Tensor>& idata)
+    {
+        const auto info = detail::parallel_info<calibrate_per_thread>(idata.size());
+
+        std::vector<std::vector<precision_type>> partial(info.first, ranges_);
+
+        auto task = [this, &idata, &partial](size_type first, size_type last, size_type thread)
+        {
+            auto buffers = net.arena();
+            auto& ranges = partial[thread];
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const Tensor* input = &idata[i];
+                for (size_type l = 0; l < net.size(); ++l)
+                {
+                    for (size_type j = 0; j < input->size(); ++j)
+                        if (std::fabs((*input)(j)) > ranges[l]) ranges[l] = std::fabs((*input)(j));
+
+                    Tensor& output = buffers.buffer[l % 2];
+
+                    output.reshape(net.inner()[l]->osize());
+                    net.inner()[l]->forward(*input, output);
+
+                    input = &output;
+                }
+            }
+        };
+
+        detail::parallel_for(info, idata.size(), task);
+
+        for (const auto& ranges : partial)
+            for (size_type l = 0; l < ranges_.size(); ++l)
+                if (ranges[l] > ranges_[l]) ranges_[l] = ranges[l];
+    }
+
+    // Return number of the replaced layers
+    size_type quantize()
+    {
+        size_type count = 0;
+
+        for (size_type l = 0; l < net.size(); ++l)
+        {
+            const precision_type scale = ranges_[l] > 0. ? ranges_[l] / 127. : 1.;
+
+            ILayer* layer = net.layer(l).quantize(scale);
+            if (layer == nullptr) continue;
+
+            delete net.replace(l, layer);
+            ++count;
+        }
+
+        return count;
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_NETWORK_QUANTIZER_HPP
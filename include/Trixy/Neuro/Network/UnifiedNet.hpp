@@ -1,6 +1,9 @@
 #ifndef TRIXY_NETWORK_UNIFIED_NET_HPP
 #define TRIXY_NETWORK_UNIFIED_NET_HPP
 
+#include <cstdint> // uint64_t
+#include <vector> // vector
+
 #include <Trixy/Neuro/Network/Base.hpp>
 #include <Trixy/Neuro/Network/Require.hpp>
 
@@ -10,6 +13,10 @@
 
 #include <Trixy/Locker/Core.hpp>
 
+#include <Trixy/Random/Core.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+
 #include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
 #include <Trixy/Neuro/Detail/MacroScope.hpp>
 
@@ -33,6 +40,10 @@ public:
     using Matrix                    = typename TypeSet::Matrix;
     using Tensor                    = typename TypeSet::Tensor;
 
+    using VectorView                = typename TypeSet::VectorView;
+    using MatrixView                = typename TypeSet::MatrixView;
+    using TensorView                = typename TypeSet::TensorView;
+
     template <typename T>
     using XContainer                = memory::ContainerLocker<Container<T>>;
 
@@ -41,6 +52,7 @@ public:
     using XTensor                   = memory::TensorLocker<Tensor>;
 
     using precision_type            = typename TypeSet::precision_type;
+    using compute_type              = typename TypeSet::compute_type;
     using size_type                 = typename TypeSet::size_type;
 
     using Linear                    = typename TypeSet::Linear;
@@ -49,6 +61,18 @@ public:
     using ITrainLayer               = layer::ITrainLayer<TrixyNet>;
 
     using Topology                  = Container<ILayer*>;
+    using Workspace                 = Container<Tensor>; ///< outputs of each layer for const feedforward
+
+    // Planned memory for const feedforward. Output of the layer i is alive only until the layer i + 1
+    // has read it, so outputs take turns in two buffers (ping-pong) of the widest layers, and
+    // peak memory doesn't depend on the network depth
+    struct Arena
+    {
+        Tensor buffer[2];
+    };
+
+private:
+    static constexpr size_type evaluate_per_thread = 32; ///< min number of samples per thread
 
 private:
     Topology inner_;
@@ -79,6 +103,7 @@ public:
         return *this;
     }
 
+    // Layer is no longer owned by the network
     bool remove(ILayer* layer)
     {
         Topology inner;
@@ -87,9 +112,20 @@ public:
         for (auto ilayer : inner_)
             if (ilayer != layer) inner.emplace_back(ilayer);
 
+        const bool is_removed = inner.size() != inner_.size();
+
         inner_ = std::move(inner);
 
-        return *this;
+        return is_removed;
+    }
+
+    // Put the layer to the place i and return previous one, it's no longer owned by the network
+    ILayer* replace(size_type i, ILayer* layer) noexcept
+    {
+        ILayer* previous = inner_[i];
+        inner_[i] = layer;
+
+        return previous;
     }
 
     const Topology& inner() const noexcept { return inner_; }
@@ -112,14 +148,125 @@ public:
         return feedforward(sample);
     }
 
+    Workspace workspace() const
+    {
+        Workspace buffers(inner_.size());
+
+        for (size_type i = 0; i < inner_.size(); ++i)
+            buffers[i].resize(inner_[i]->osize());
+
+        return buffers;
+    }
+
+    Arena arena() const
+    {
+        size_type capacity[2] = {0, 0};
+
+        for (size_type i = 0; i < inner_.size(); ++i)
+            if (inner_[i]->osize().size > capacity[i % 2]) capacity[i % 2] = inner_[i]->osize().size;
+
+        Arena arena;
+        for (size_type k = 0; k < 2; ++k) arena.buffer[k].resize(1, 1, capacity[k]);
+
+        return arena;
+    }
+
+    // Doesn't change the network state, so it's safe to call it from many threads,
+    // if each of them has own workspace
+    const Tensor& feedforward(const Tensor& sample, Workspace& workspace) const noexcept
+    {
+        inner_[0]->forward(sample, workspace[0]);
+
+        for (size_type i = 1; i < inner_.size(); ++i)
+            inner_[i]->forward(workspace[i - 1], workspace[i]);
+
+        return workspace[inner_.size() - 1];
+    }
+
+    // Same as above, but only the last output stays valid
+    const Tensor& feedforward(const Tensor& sample, Arena& arena) const noexcept
+    {
+        const Tensor* input = &sample;
+
+        for (size_type i = 0; i < inner_.size(); ++i)
+        {
+            Tensor& output = arena.buffer[i % 2];
+
+            output.reshape(inner_[i]->osize());
+            inner_[i]->forward(*input, output);
+
+            input = &output;
+        }
+
+        return *input;
+    }
+
+    // Parallel reduction of the predictions over whole dataset.
+    // Each thread takes own copy of the init and the function, and calls function(result, i, prediction)
+    // for samples from own block, after that partial results will be merged with operator+=.
+    // Note that init should be an empty (neutral) value, since it's copied for each thread
+    template <class Accumulator, class Function>
+    Accumulator evaluate(const Container<Tensor>& idata, Accumulator init, Function function) const
+    {
+        const auto info = detail::parallel_info<evaluate_per_thread>(idata.size());
+
+        // small data or single core, without threads and partial results
+        if (info.first == 1)
+        {
+            Arena buffers = arena();
+
+            for (size_type i = 0; i < idata.size(); ++i)
+                function(init, i, feedforward(idata[i], buffers));
+
+            return init;
+        }
+
+        std::vector<Accumulator> partial(info.first, init);
+
+        auto task = [this, &idata, &init, &partial, &function]
+        (size_type first, size_type last, size_type thread)
+        {
+            Arena buffers = arena();
+
+            Function local = function;
+            Accumulator result = init;
+
+            for (size_type i = first; i < last; ++i)
+                local(result, i, feedforward(idata[i], buffers));
+
+            partial[thread] = std::move(result);
+        };
+
+        detail::parallel_for(info, idata.size(), task);
+
+        for (size_type i = 1; i < partial.size(); ++i)
+            partial[0] += partial[i];
+
+        return std::move(partial[0]);
+    }
+
+    // Mixed precision layers refresh their compute copy in parallel, so it isn't noexcept
     template <class FloatGenerator>
-    void init(FloatGenerator functor) noexcept
+    void init(FloatGenerator functor)
     {
         typename ILayer::Generator generator{functor};
 
         for (size_type i = 0; i < inner_.size(); ++i)
             layer(i).init(generator);
     }
+
+    // Layers are initialized one by one, each from own Philox stream of the seed.
+    // Weights of the layer are generated in parallel, so result doesn't depend on the number of threads
+    void init(functional::InitializationId id, std::uint64_t seed)
+    {
+        utility::Philox generator(seed);
+
+        for (size_type i = 0; i < inner_.size(); ++i)
+        {
+            utility::Philox stream = generator.split(i);
+            layer(i).init(id, stream);
+        }
+    }
 };
 
 } // namespace trixy
@@ -0,0 +1,292 @@
+#ifndef TRIXY_SERIALIZER_CHECKPOINT_HPP
+#define TRIXY_SERIALIZER_CHECKPOINT_HPP
+
+#include <algorithm> // sort
+#include <condition_variable> // condition_variable
+#include <cstdio> // rename, remove, snprintf
+#include <cstdlib> // strtoull
+#include <deque> // deque
+#include <fstream> // ifstream, ofstream
+#include <mutex> // mutex, unique_lock, lock_guard
+#include <string> // string
+#include <thread> // thread
+#include <vector> // vector
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define TRIXY_CHECKPOINT_POSIX
+    #include <dirent.h> // opendir, readdir, closedir
+    #include <fcntl.h> // open
+    #include <unistd.h> // fsync, close
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#include <Trixy/Serializer/Core.hpp>
+
+#include <Trixy/Neuro/Detail/MacroScope.hpp>
+#include <Trixy/Detail/MetaMacro.hpp>
+
+namespace trixy
+{
+
+// Asynchronous checkpoint writer.
+// snapshot() archives the model into the front buffer on the calling thread, then swaps
+// it with the back buffer, which the background thread writes to the disk in the Serializer format.
+// The caller waits only if the previous checkpoint is still being written.
+// Each file is written as 'path.tmp' and renamed when complete, so a crash never leaves
+// a partially written checkpoint under the final name. Only the last 'retention' files are kept.
+// Files of the previous run with the same prefix are found on construction (POSIX only),
+// so a resumed job continues their numbering and old files are removed by the retention
+TRIXY_SERIALIZER_TEMPLATE()
+class Checkpoint
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    std::string prefix_;
+    size_type retention_;
+
+    std::vector<unsigned char> front_;  ///< filled by snapshot()
+    std::vector<unsigned char> back_;   ///< owned by the writer until it's done
+
+    std::deque<std::string> written_;
+
+    size_type index_;
+
+    bool busy_;
+    bool stop_;
+    bool fail_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+
+    std::thread writer_;
+
+public:
+    // Files will be named as 'prefix.000001.bin', 'prefix.000002.bin', ...
+    explicit Checkpoint(const char* prefix, size_type retention = 2)
+        : prefix_(prefix), retention_(retention > 0 ? retention : 1)
+        , front_(), back_(), written_()
+        , index_(0), busy_(false), stop_(false), fail_(false)
+        , mutex_(), condition_()
+        , writer_(&Checkpoint::run, this)
+    {
+        scan();
+    }
+
+    ~Checkpoint()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        condition_.notify_all();
+        writer_.join();
+    }
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator= (const Checkpoint&) = delete;
+
+    // Additional serializable objects (e.g. optimizer) will be stored after the model
+    template <class... Serializables>
+    void snapshot(Serializable& serializable, Serializables&... serializables)
+    {
+        front_.clear();
+        {
+            auto archive = sf::oarchive(front_);
+            serialize(archive, serializable, serializables...);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return not busy_; });
+
+        front_.swap(back_);
+        busy_ = true;
+
+        lock.unlock();
+        condition_.notify_all();
+    }
+
+    // Restore the model and extras from the checkpoint file in the order of snapshot(),
+    // return false if the file can't be read
+    template <class... Serializables>
+    static bool load(const std::string& path, Serializable& serializable, Serializables&... serializables)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (not in.is_open()) return false;
+
+        std::vector<unsigned char> storage;
+        {
+            auto archive = sf::iarchive<sf::wrapper::ifile_stream_t<std::ifstream>>(in);
+            archive & storage;
+        }
+
+        if (not in) return false;
+        {
+            auto archive = sf::iarchive(storage);
+            serialize(archive, serializable, serializables...);
+        }
+
+        return true;
+    }
+
+    // Block until the last snapshot is written
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return not busy_; });
+    }
+
+    // Path of the last completely written checkpoint (of this or previous run) or empty string
+    std::string last() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return written_.empty() ? std::string() : written_.back();
+    }
+
+    // Return true if any checkpoint was not written
+    bool fail() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fail_;
+    }
+
+private:
+    template <class Archive>
+    static void serialize(Archive&) noexcept { /*pass*/ }
+
+    template <class Archive, class T, class... Tn>
+    static void serialize(Archive& archive, T& object, Tn&... objects)
+    {
+        archive & object;
+        serialize(archive, objects...);
+    }
+
+    void scan()
+    {
+    #ifdef TRIXY_CHECKPOINT_POSIX
+        const std::string::size_type slash = prefix_.rfind('/');
+
+        const std::string directory = slash == std::string::npos ? "." : prefix_.substr(0, slash + 1);
+        const std::string base = (slash == std::string::npos ? prefix_ : prefix_.substr(slash + 1)) + ".";
+
+        DIR* dir = ::opendir(directory.c_str());
+        if (dir == nullptr) return;
+
+        std::vector<size_type> indices;
+
+        size_type index;
+        while (const dirent* entry = ::readdir(dir))
+            if (parse(entry->d_name, base, index)) indices.push_back(index);
+
+        ::closedir(dir);
+
+        std::sort(indices.begin(), indices.end());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto i : indices) written_.push_back(name(i));
+
+        if (not indices.empty()) index_ = indices.back();
+    #endif // TRIXY_CHECKPOINT_POSIX
+    }
+
+    // Match 'base' + digits + '.bin', where base is the prefix file name with the dot
+    static bool parse(const std::string& file, const std::string& base, size_type& index)
+    {
+        static const std::string extension = ".bin";
+
+        if (file.size() <= base.size() + extension.size()) return false;
+        if (file.compare(0, base.size(), base) != 0) return false;
+        if (file.compare(file.size() - extension.size(), extension.size(), extension) != 0) return false;
+
+        const std::string number = file.substr(base.size(), file.size() - base.size() - extension.size());
+        for (char c : number)
+            if (c < '0' || c > '9') return false;
+
+        index = static_cast<size_type>(std::strtoull(number.c_str(), nullptr, 10));
+        return true;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true)
+        {
+            condition_.wait(lock, [this] { return busy_ || stop_; });
+            if (not busy_) return; // stop only after the pending checkpoint
+
+            const std::string path = name(++index_);
+
+            lock.unlock();
+            const bool success = write(path);
+            lock.lock();
+
+            if (success)
+            {
+                written_.push_back(path);
+
+                while (written_.size() > retention_)
+                {
+                    std::remove(written_.front().c_str());
+                    written_.pop_front();
+                }
+            }
+            else fail_ = true;
+
+            busy_ = false;
+            condition_.notify_all();
+        }
+    }
+
+    bool write(const std::string& path)
+    {
+        const std::string temporary = path + ".tmp";
+
+        std::ofstream out(temporary, std::ios::binary);
+        if (not out.is_open()) return false;
+
+        {
+            auto archive = sf::oarchive<sf::wrapper::ofile_stream_t<std::ofstream>>(out);
+            archive & back_;
+        }
+
+        out.close();
+        if (not out || not sync(temporary)
+            || std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    // Flush file data to the device before rename
+    static bool sync(const std::string& path) noexcept
+    {
+    #ifdef TRIXY_CHECKPOINT_POSIX
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+
+        bool success = ::fsync(fd) == 0;
+        ::close(fd);
+
+        return success;
+    #else
+        return true;
+    #endif // TRIXY_CHECKPOINT_POSIX
+    }
+
+    std::string name(size_type index) const
+    {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%06zu", index);
+
+        return prefix_ + "." + number + ".bin";
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_SERIALIZER_CHECKPOINT_HPP
@@ -0,0 +1,135 @@
+#ifndef TRIXY_SERIALIZER_MAPPED_HPP
+#define TRIXY_SERIALIZER_MAPPED_HPP
+
+#include <cstdint> // uint32_t, uint64_t
+#include <cstring> // memcpy, memcmp
+#include <memory> // make_shared
+#include <vector> // vector
+
+#include <Trixy/Serializer/Core.hpp>
+#include <Trixy/Serializer/Mapping.hpp>
+
+#include <Trixy/Neuro/Detail/MacroScope.hpp>
+#include <Trixy/Detail/MetaMacro.hpp>
+
+namespace trixy
+{
+
+// Binary model format for the zero-copy loading:
+// [header][archive of the model without tensor data][aligned tensor data blobs]
+// Raw layers refer to the mapped blobs directly, Train layers take a copy of them.
+// Data are stored in the native byte order
+TRIXY_SERIALIZER_TEMPLATE()
+class MappedSerializer
+{
+public:
+    using precision_type = typename Serializable::precision_type;
+
+    using byte_type = unsigned char;
+    using size_type = std::size_t;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t precision_size;
+        std::uint64_t skeleton_offset;
+        std::uint64_t skeleton_size;
+        std::uint64_t blob_offset;
+        std::uint64_t blob_size;
+    };
+
+    static constexpr std::uint32_t version = 1;
+
+public:
+    template <class OutStream>
+    static void serialize(OutStream& out, Serializable& serializable)
+    {
+        memory::MappingScope scope;
+
+        std::vector<byte_type> skeleton;
+        {
+            auto archive = sf::oarchive(skeleton);
+            archive & serializable;
+        }
+
+        Header header;
+        std::memcpy(header.magic, magic(), sizeof(header.magic));
+        header.version = version;
+        header.precision_size = sizeof(precision_type);
+        header.skeleton_offset = memory::MappingScope::align(sizeof(Header));
+        header.skeleton_size = skeleton.size();
+        header.blob_offset = memory::MappingScope::align(header.skeleton_offset + header.skeleton_size);
+        header.blob_size = 0;
+
+        for (const auto& blob : scope.blobs())
+            header.blob_size = memory::MappingScope::align(header.blob_size) + blob.second;
+
+        write(out, &header, sizeof(Header));
+        pad(out, sizeof(Header));
+
+        write(out, skeleton.data(), skeleton.size());
+        pad(out, header.skeleton_offset + header.skeleton_size);
+
+        size_type offset = 0;
+        for (const auto& blob : scope.blobs())
+        {
+            pad(out, offset);
+            offset = memory::MappingScope::align(offset);
+
+            write(out, blob.first, blob.second);
+            offset += blob.second;
+        }
+    }
+
+    // Return false if file cannot be opened or it has unsupported format
+    static bool deserialize(const char* path, Serializable& serializable)
+    {
+        auto file = std::make_shared<memory::MappedFile>(path);
+        if (not file->is_open() || file->size() < sizeof(Header)) return false;
+
+        Header header;
+        std::memcpy(&header, file->data(), sizeof(Header));
+
+        if (std::memcmp(header.magic, magic(), sizeof(header.magic)) != 0
+            || header.version != version
+            || header.precision_size != sizeof(precision_type)
+            || header.skeleton_size > file->size()
+            || header.skeleton_offset > file->size() - header.skeleton_size
+            || header.blob_size > file->size()
+            || header.blob_offset > file->size() - header.blob_size)
+            return false;
+
+        auto first = file->data() + header.skeleton_offset;
+        std::vector<byte_type> skeleton(first, first + header.skeleton_size);
+
+        memory::MappingScope scope(file->data() + header.blob_offset, header.blob_size, file);
+        {
+            auto archive = sf::iarchive(skeleton);
+            archive & serializable;
+        }
+
+        return not scope.fail();
+    }
+
+private:
+    static const char* magic() noexcept { return "TRIXYMAP"; }
+
+    template <class OutStream>
+    static void write(OutStream& out, const void* data, size_type size)
+    {
+        out.write(static_cast<const char*>(data), size);
+    }
+
+    // Write zeros up to the next aligned offset
+    template <class OutStream>
+    static void pad(OutStream& out, size_type offset)
+    {
+        static const char zeros[memory::MappingScope::alignment] = {};
+        out.write(zeros, memory::MappingScope::align(offset) - offset);
+    }
+};
+
+} // namespace trixy
+
+#endif // TRIXY_SERIALIZER_MAPPED_HPP
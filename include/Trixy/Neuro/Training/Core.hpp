@@ -7,5 +7,6 @@
 
 #include <Trixy/Neuro/Training/LinearRegression.hpp>
 #include <Trixy/Neuro/Training/PolynomialRegression.hpp>
+#include <Trixy/Neuro/Training/NormalEquations.hpp>
 
 #endif // TRIXY_TRAINING_CORE_HPP
@@ -2,6 +2,7 @@
 #define TRIXY_TRAINING_LINEAR_REGRESSION_HPP
 
 #include <Trixy/Neuro/Training/Base.hpp>
+#include <Trixy/Neuro/Training/NormalEquations.hpp>
 #include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
 
 #include <Trixy/Neuro/Detail/MacroScope.hpp>
@@ -29,33 +30,44 @@ public:
 private:
     Trainable& reg;
 
+    NormalEquations equations_;
+
 public:
-    explicit Training(Trainable& regression) : reg(regression) {}
+    explicit Training(Trainable& regression) : reg(regression), equations_(regression.N) {}
 
-    void train(const Matrix& idata,
+    // Fit the whole data at once, return false if the system is singular
+    bool train(const Matrix& idata,
                const Vector& odata)
     {
-        Matrix X(idata.shape().height, reg.N);
+        reset();
+        accumulate(idata, odata);
+
+        return fit();
+    }
+
+    // Streaming mode: accumulate data chunk by chunk, then fit()
+    void accumulate(const Matrix& idata,
+                    const Vector& odata)
+    {
+        const size_type N = reg.N;
 
-        for (size_type i = 0; i < X.shape().height; ++i)
+        // regression may be reset or loaded after the training was created
+        if (equations_.features() != N) equations_ = NormalEquations(N);
+
+        equations_.accumulate(idata.shape().height, [&idata, &odata, N](size_type i, double* x)
         {
-            X(i, 0) = 1.;
-            for (size_type j = 1; j < reg.N; ++j)
-                X(i, j) = idata(i, j - 1);
-        }
-
-        Matrix X_T = reg.linear.transpose(X);
-        Matrix X_T_X = reg.linear.dot(X_T, X);
-
-        // W = (X^T . X)^(-1) . X^T . Y
-        reg.linear.dot(
-            reg.W,
-            // (X^T . X)^(-1) . X^T
-            reg.linear.dot(reg.linear.inverse(X_T_X), X_T),
-            odata
-        );
+            x[0] = 1.;
+            for (size_type j = 1; j < N; ++j)
+                x[j] = idata(i, j - 1);
+
+            return odata(i);
+        });
     }
 
+    bool fit() { return equations_.solve(reg.W); }
+
+    void reset() noexcept { equations_.reset(); }
+
     double loss(const Matrix& idata,
                      const Vector& odata) const
     {
@@ -0,0 +1,140 @@
+#ifndef TRIXY_TRAINING_NORMAL_EQUATIONS_HPP
+#define TRIXY_TRAINING_NORMAL_EQUATIONS_HPP
+
+#include <cstddef> // size_t
+#include <vector> // vector
+
+#include <Trixy/Lique/Linear.hpp>
+#include <Trixy/Lique/Matrix.hpp>
+#include <Trixy/Lique/Vector.hpp>
+
+#include <Trixy/Detail/FunctionDetail.hpp>
+
+namespace trixy
+{
+
+namespace train
+{
+
+// Streaming least squares: X^T . X and X^T . Y are accumulated chunk by chunk,
+// each row of X is generated on the fly, so X is never built.
+// Sums are kept in double, rows of the chunk are split between threads with own partial sums
+class NormalEquations
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    using Matrix = lique::Matrix<double>;
+    using Vector = lique::Vector<double>;
+
+    static constexpr size_type rows_per_thread = 1 << 14;
+
+private:
+    size_type N_;       ///< number of features
+    size_type count_;   ///< number of accumulated rows
+
+    Matrix X_T_X_;      ///< only upper triangle is accumulated
+    Vector X_T_Y_;
+
+public:
+    explicit NormalEquations(size_type features = 0)
+        : N_(features), count_(0), X_T_X_(features, features), X_T_Y_(features)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        X_T_X_.fill(0.);
+        X_T_Y_.fill(0.);
+        count_ = 0;
+    }
+
+    size_type count() const noexcept { return count_; }
+    size_type features() const noexcept { return N_; }
+
+    // Accumulate rows [0, rows), row(i, x) MUST write N features of row i to x and return its target
+    template <class Row>
+    void accumulate(size_type rows, Row row)
+    {
+        auto info = trixy::detail::parallel_info<rows_per_thread>(rows);
+
+        std::vector<Matrix> partial_X_T_X(info.first - 1, Matrix(N_, N_));
+        std::vector<Vector> partial_X_T_Y(info.first - 1, Vector(N_));
+
+        auto task = [this, &row, &partial_X_T_X, &partial_X_T_Y](size_type first, size_type last, size_type thread)
+        {
+            // the last block is accumulated to the main sums on the calling thread
+            const bool is_main = thread == partial_X_T_X.size();
+
+            Matrix& X_T_X = is_main ? X_T_X_ : partial_X_T_X[thread];
+            Vector& X_T_Y = is_main ? X_T_Y_ : partial_X_T_Y[thread];
+
+            if (not is_main)
+            {
+                X_T_X.fill(0.);
+                X_T_Y.fill(0.);
+            }
+
+            std::vector<double> x(N_);
+
+            for (size_type i = first; i < last; ++i)
+            {
+                const double y = static_cast<double>(row(i, x.data()));
+
+                for (size_type j = 0; j < N_; ++j)
+                {
+                    double* out = X_T_X.data() + j * N_;
+                    const double xj = x[j];
+
+                    for (size_type k = j; k < N_; ++k) out[k] += xj * x[k];
+
+                    X_T_Y(j) += xj * y;
+                }
+            }
+        };
+
+        trixy::detail::parallel_for(info, rows, task);
+
+        for (size_type t = 0; t < partial_X_T_X.size(); ++t)
+        {
+            lique::detail::assign(X_T_X_.data(), X_T_X_.data() + X_T_X_.size(), lique::detail::add(), partial_X_T_X[t].data());
+            lique::detail::assign(X_T_Y_.data(), X_T_Y_.data() + X_T_Y_.size(), lique::detail::add(), partial_X_T_Y[t].data());
+        }
+
+        count_ += rows;
+    }
+
+    // Solve (X^T . X) . W = X^T . Y by Cholesky, or by LU if X hasn't full rank.
+    // Return false if system is singular
+    template <class Weight>
+    bool solve(Weight& W) const
+    {
+        lique::Linear<double> linear;
+
+        Matrix X_T_X(N_, N_);
+        for (size_type j = 0; j < N_; ++j)
+            for (size_type k = 0; k < N_; ++k)
+                X_T_X(j, k) = j <= k ? X_T_X_(j, k) : X_T_X_(k, j);
+
+        Matrix factorization(N_, N_);
+        factorization.copy(X_T_X);
+
+        Vector result(N_);
+
+        if (not linear.solve_spd(result, factorization, X_T_Y_)
+            && not linear.solve(result, X_T_X, X_T_Y_)) return false;
+
+        for (size_type j = 0; j < N_; ++j)
+            W(j) = static_cast<typename Weight::precision_type>(result(j));
+
+        return true;
+    }
+};
+
+} // namespace train
+
+} // namespace trixy
+
+#endif // TRIXY_TRAINING_NORMAL_EQUATIONS_HPP
@@ -2,6 +2,7 @@
 #define TRIXY_TRAINING_POLYNOMIAL_REGRESSION_HPP
 
 #include <Trixy/Neuro/Training/Base.hpp>
+#include <Trixy/Neuro/Training/NormalEquations.hpp>
 #include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
 
 #include <Trixy/Neuro/Detail/MacroScope.hpp>
@@ -29,41 +30,49 @@ public:
 private:
     Trainable& reg;
 
+    NormalEquations equations_;
+
 public:
-    explicit Training(Trainable& regression) : reg(regression) {}
+    explicit Training(Trainable& regression) : reg(regression), equations_(regression.N) {}
 
-    void train(const Vector& idata,
+    // Fit the whole data at once, return false if the system is singular
+    bool train(const Vector& idata,
                const Vector& odata)
     {
-        Matrix X(idata.size(), reg.N);
+        reset();
+        accumulate(idata, odata);
+
+        return fit();
+    }
+
+    // Streaming mode: accumulate data chunk by chunk, then fit()
+    void accumulate(const Vector& idata,
+                    const Vector& odata)
+    {
+        const size_type N = reg.N;
 
-        precision_type sample;
-        precision_type power;
+        // regression may be reset or loaded after the training was created
+        if (equations_.features() != N) equations_ = NormalEquations(N);
 
-        for (size_type i = 0; i < idata.size(); ++i)
+        equations_.accumulate(idata.size(), [&idata, &odata, N](size_type i, double* x)
         {
-            sample = idata(i);
-            power  = 1.;
+            const double sample = idata(i);
+            double power = 1.;
 
-            for (size_type j = 0; j < reg.N; ++j)
+            for (size_type j = 0; j < N; ++j)
             {
-                X(i, j) = power;
-                power  *= sample;
+                x[j] = power;
+                power *= sample;
             }
-        }
-
-        Matrix X_T = reg.linear.transpose(X);
-        Matrix X_T_X = reg.linear.dot(X_T, X);
-
-        // W = (X^T . X)^(-1) . X^T . Y
-        reg.linear.dot(
-            reg.W,
-            // (X^T . X)^(-1) . X^T
-            reg.linear.dot(reg.linear.inverse(X_T_X), X_T),
-            odata
-        );
+
+            return odata(i);
+        });
     }
 
+    bool fit() { return equations_.solve(reg.W); }
+
+    void reset() noexcept { equations_.reset(); }
+
     double loss(const Vector& idata,
                      const Vector& odata) const
     {
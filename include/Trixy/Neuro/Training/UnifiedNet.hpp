@@ -1,10 +1,17 @@
 #ifndef TRIXY_TRAINING_UNIFIED_NET_HPP
 #define TRIXY_TRAINING_UNIFIED_NET_HPP
 
+#include <functional> // function
+#include <vector> // vector
+
 #include <Trixy/Neuro/Training/Base.hpp>
 
 #include <Trixy/Neuro/Functional/Function/Base.hpp>
 #include <Trixy/Neuro/Functional/Optimizer/Base.hpp>
+#include <Trixy/Neuro/Functional/Optimizer/Interface.hpp>
+
+#include <Trixy/Neuro/Serializer/Checkpoint.hpp>
+#include <Trixy/Neuro/Dataset/Loader.hpp>
 
 #include <Trixy/Neuro/Detail/TrixyNetMeta.hpp>
 
@@ -44,10 +51,13 @@ public:
     using size_type                 = typename Net::size_type;
 
     using ITrainLayer               = typename Net::ITrainLayer;
+    using shape_type                = typename Tensor::shape_type;
 
     using ILoss                     = functional::loss::ILoss<precision_type>;
     using IOptimizer                = train::IOptimizer<Net>;
 
+    using Checkpoint                = trixy::Checkpoint<Net>;
+
 private:
     Net& net;                       ///< reference to network prevent her copying
 
@@ -55,9 +65,31 @@ private:
 
     ILoss* loss_;
 
+    Checkpoint* checkpoint_;        ///< not owned
+    size_type checkpoint_interval_;
+    std::function<void()> snapshot_; ///< archives the model with extras to the checkpoint
+    size_type step_;                ///< number of model updates
+
+    std::vector<typename IOptimizer::Parameter> parameters_; ///< reusable list for the update_all()
+
+    size_type segment_;             ///< number of layers between the kept activations, 0 keeps all
+    Container<Tensor> checkpoints_; ///< input of each segment, except the first one
+
+    // Forward caches are lent to the layers outside the last segment from 'slots_' sets of 'width_' buffers,
+    // layer i takes the set i % slots_, so the layers of one segment and two adjacent layers never share it
+    Container<Tensor> buffers_;
+    std::vector<shape_type> shapes_; ///< cache shapes of these layers one by one
+    std::vector<size_type> offsets_; ///< first cache shape of the layer i, one more for the end
+    size_type slots_;
+    size_type width_;
+
+    static constexpr size_type load_size = 256; ///< number of samples converted at once by batch()
+
 public:
     explicit Training(Net& network)
         : net(network), delta(network.inner().back()->osize()), loss_(nullptr)
+        , checkpoint_(nullptr), checkpoint_interval_(0), snapshot_(), step_(0), parameters_()
+        , segment_(0), checkpoints_(), buffers_(), shapes_(), offsets_(), slots_(0), width_(0)
     {
     }
 
@@ -70,16 +102,23 @@ public:
     Training(const Training&) = default;
     Training(Training&&) noexcept = default;
 
+    // Samples are drawn without replacement: each pass over the dataset takes them
+    // in the new random order. Generator requirements are described by data::draw(), e.g. std::mt19937
     template <class GeneratorInteger>
     void stochastic(const Container<Tensor>& idata,
                     const Container<Tensor>& odata,
                     IOptimizer& optimizer,
                     size_type iteration_scale,
-                    GeneratorInteger generator) noexcept
+                    GeneratorInteger generator)
     {
-        for (size_type iteration = 0, sample; iteration < iteration_scale; ++iteration)
+        std::vector<size_type> order = permutation(idata.size());
+
+        for (size_type iteration = 0, position, sample; iteration < iteration_scale; ++iteration)
         {
-            sample = generator() % idata.size();
+            position = iteration % order.size();
+            if (position == 0) data::shuffle(order.data(), order.data() + order.size(), generator);
+
+            sample = order[position];
 
             feedforward(idata[sample]);
             backprop(idata[sample], odata[sample]);
@@ -92,20 +131,45 @@ public:
     void batch(const Container<Tensor>& idata,
                const Container<Tensor>& odata,
                IOptimizer& optimizer,
-               size_type number_of_epochs) noexcept
+               size_type number_of_epochs)
     {
         precision_type alpha = 1. / static_cast<precision_type>(idata.size());
 
-        for (size_type epoch = 0, sample; epoch < number_of_epochs; ++epoch)
+        for (size_type epoch = 0; epoch < number_of_epochs; ++epoch)
         {
             reseting();
+            learning(idata, odata, 0, idata.size());
+            updating(optimizer, alpha);
+        }
+    }
 
-            for (sample = 0; sample < idata.size(); ++sample)
+    // Dataset source is any type with size() and load(first, count, batch) members,
+    // e.g. data::Dataset or data::IdxFile, samples are converted to the precision type
+    // by small parts, so whole dataset is never materialized
+    template <class InputSource, class OutputSource>
+    void batch(const InputSource& idata,
+               const OutputSource& odata,
+               IOptimizer& optimizer,
+               size_type number_of_epochs)
+    {
+        precision_type alpha = 1. / static_cast<precision_type>(idata.size());
+
+        Container<Tensor> ibatch;
+        Container<Tensor> obatch;
+
+        for (size_type epoch = 0, first, count; epoch < number_of_epochs; ++epoch)
+        {
+            reseting();
+
+            for (first = 0; first < idata.size(); first += load_size)
             {
-                feedforward(idata[sample]);
-                backprop(idata[sample], odata[sample]);
+                count = idata.size() - first;
+                if (count > load_size) count = load_size;
+
+                idata.load(first, count, ibatch);
+                odata.load(first, count, obatch);
 
-                accumulating();
+                learning(ibatch, obatch, 0, count);
             }
 
             updating(optimizer, alpha);
@@ -116,7 +180,7 @@ public:
                     const Container<Tensor>& odata,
                     IOptimizer& optimizer,
                     size_type number_of_epochs,
-                    size_type mini_batch_size) noexcept
+                    size_type mini_batch_size)
     {
         precision_type alpha = 1. / static_cast<precision_type>(mini_batch_size);
 
@@ -138,16 +202,147 @@ public:
                 reseting();
 
                 // accumulating deltas for one mini-batch
-                while (sample < sample_limit)
-                {
-                    feedforward(idata[sample]);
-                    backprop(idata[sample], odata[sample]);
+                learning(idata, odata, sample, sample_limit);
+                sample = sample_limit;
+
+                // averaging deltas for one mini-batch
+                updating(optimizer, alpha);
+            }
+        }
+    }
 
-                    accumulating();
+    // Samples are shuffled at the beginning of each epoch, generator as for the stochastic().
+    // If gather is true, each mini-batch is copied to the contiguous reusable tensors,
+    // otherwise samples are taken from the dataset by indices
+    template <class Generator>
+    void mini_batch(const Container<Tensor>& idata,
+                    const Container<Tensor>& odata,
+                    IOptimizer& optimizer,
+                    size_type number_of_epochs,
+                    size_type mini_batch_size,
+                    Generator& generator,
+                    bool gather = true)
+    {
+        precision_type alpha = 1. / static_cast<precision_type>(mini_batch_size);
+
+        // number of iterations per full batch
+        size_type iteration_scale = idata.size() / mini_batch_size; // implicit drop floating part
+
+        std::vector<size_type> order = permutation(idata.size());
+
+        Container<Tensor> ibatch;
+        Container<Tensor> obatch;
+
+        for (size_type epoch = 0, iteration; epoch < number_of_epochs; ++epoch)
+        {
+            data::shuffle(order.data(), order.data() + order.size(), generator);
+
+            for (iteration = 0; iteration < iteration_scale; ++iteration)
+            {
+                const size_type* indices = order.data() + iteration * mini_batch_size;
+
+                reseting();
+
+                if (gather)
+                {
+                    data::gather(idata, indices, mini_batch_size, ibatch);
+                    data::gather(odata, indices, mini_batch_size, obatch);
 
-                    ++sample;
+                    learning(ibatch, obatch, 0, mini_batch_size);
                 }
-                // averaging deltas for one mini-batch
+                else learning_subset(idata, odata, indices, mini_batch_size);
+
+                updating(optimizer, alpha);
+            }
+        }
+    }
+
+    // Each mini-batch is converted from the dataset source to the reusable tensors,
+    // see batch() for the source requirements
+    template <class InputSource, class OutputSource>
+    void mini_batch(const InputSource& idata,
+                    const OutputSource& odata,
+                    IOptimizer& optimizer,
+                    size_type number_of_epochs,
+                    size_type mini_batch_size)
+    {
+        precision_type alpha = 1. / static_cast<precision_type>(mini_batch_size);
+
+        // number of iterations per full batch
+        size_type iteration_scale = idata.size() / mini_batch_size; // implicit drop floating part
+
+        Container<Tensor> ibatch;
+        Container<Tensor> obatch;
+
+        for (size_type epoch = 0, iteration; epoch < number_of_epochs; ++epoch)
+        {
+            for (iteration = 0; iteration < iteration_scale; ++iteration)
+            {
+                idata.load(iteration * mini_batch_size, mini_batch_size, ibatch);
+                odata.load(iteration * mini_batch_size, mini_batch_size, obatch);
+
+                reseting();
+                learning(ibatch, obatch, 0, mini_batch_size);
+                updating(optimizer, alpha);
+            }
+        }
+    }
+
+    // Shuffled mini-batches are gathered from the dataset source by indices
+    template <class InputSource, class OutputSource, class Generator>
+    void mini_batch(const InputSource& idata,
+                    const OutputSource& odata,
+                    IOptimizer& optimizer,
+                    size_type number_of_epochs,
+                    size_type mini_batch_size,
+                    Generator& generator)
+    {
+        precision_type alpha = 1. / static_cast<precision_type>(mini_batch_size);
+
+        // number of iterations per full batch
+        size_type iteration_scale = idata.size() / mini_batch_size; // implicit drop floating part
+
+        std::vector<size_type> order = permutation(idata.size());
+
+        Container<Tensor> ibatch;
+        Container<Tensor> obatch;
+
+        for (size_type epoch = 0, iteration; epoch < number_of_epochs; ++epoch)
+        {
+            data::shuffle(order.data(), order.data() + order.size(), generator);
+
+            for (iteration = 0; iteration < iteration_scale; ++iteration)
+            {
+                const size_type* indices = order.data() + iteration * mini_batch_size;
+
+                data::gather(idata, indices, mini_batch_size, ibatch);
+                data::gather(odata, indices, mini_batch_size, obatch);
+
+                reseting();
+                learning(ibatch, obatch, 0, mini_batch_size);
+                updating(optimizer, alpha);
+            }
+        }
+    }
+
+    // Batches are prepared by the loader workers while the current one is being trained on
+    template <class LoaderTypeSet, class InputSource, class OutputSource>
+    void mini_batch(data::DataLoader<LoaderTypeSet, InputSource, OutputSource>& loader,
+                    IOptimizer& optimizer,
+                    size_type number_of_epochs)
+    {
+        precision_type alpha = 1. / static_cast<precision_type>(loader.batch_size());
+
+        for (size_type epoch = 0, iteration; epoch < number_of_epochs; ++epoch)
+        {
+            for (iteration = 0; iteration < loader.batches(); ++iteration)
+            {
+                const auto& batch = loader.acquire();
+
+                reseting();
+                learning(batch.input, batch.target, 0, loader.batch_size());
+                loader.release();
+
                 updating(optimizer, alpha);
             }
         }
@@ -155,7 +350,28 @@ public:
 
     void feedforward(const Tensor& sample) noexcept
     {
-        net.feedforward(sample);
+        if (segment_ == 0)
+        {
+            net.feedforward(sample);
+            return;
+        }
+
+        const size_type last = (net.size() - 1) / segment_ * segment_; // first layer of the last segment
+
+        const Tensor* input = &sample;
+        for (size_type i = 0; i < net.size(); ++i)
+        {
+            if (i < last) lend(i);
+            layer(i).forward(*input);
+
+            // output of the previous layer has been read, the last segment keeps own activations
+            if (i > 0 && i - 1 < last) reclaim(i - 1);
+
+            if ((i + 1) % segment_ == 0 && i + 1 <= last)
+                checkpoints_[(i + 1) / segment_ - 1].copy(layer(i).value());
+
+            input = &layer(i).value();
+        }
     }
 
     void backprop(const Tensor& sample,
@@ -165,20 +381,112 @@ public:
 
         loss_->df(delta, target, layer(N - 1).value());
 
-        layer(N - 1).backward(layer(N - 2).value(), delta);
+        if (segment_ == 0)
+        {
+            backward(sample, 0, N);
+            return;
+        }
+
+        size_type first = (N - 1) / segment_ * segment_;
+        backward(boundary(sample, first), first, N);
 
-        for (size_type i = N - 2; i > 0; --i)
-            layer(i).backward(layer(i - 1).value(), layer(i + 1).delta());
+        while (first > 0)
+        {
+            first -= segment_;
+
+            // activations of the segment are recomputed from its stored input
+            const Tensor& input = boundary(sample, first);
 
-        layer(0).backward(sample, layer(1).delta(), false);
+            const Tensor* value = &input;
+            for (size_type i = first; i < first + segment_; ++i)
+            {
+                lend(i);
+                layer(i).forward(*value);
+                value = &layer(i).value();
+            }
+
+            backward(input, first, first + segment_);
+
+            for (size_type i = first; i < first + segment_; ++i) reclaim(i);
+        }
+    }
+
+    // Gradient checkpointing: the forward keeps only the input of each segment of layers,
+    // and backprop recomputes activations of the segment before its backward, that costs
+    // about one extra forward. Pass 0 to keep all activations.
+    // Layers outside the last segment free own caches here and get planned buffers during
+    // the training step only, so the net MUST NOT be run by feedforward(sample) until recompute(0)
+    void recompute(size_type segment)
+    {
+        restore();
+
+        segment_ = segment;
+
+        checkpoints_ = Container<Tensor>();
+        buffers_ = Container<Tensor>();
+        shapes_.clear();
+        offsets_.clear();
+        slots_ = 0;
+        width_ = 0;
+
+        if (segment_ == 0) return;
+
+        const size_type last = (net.size() - 1) / segment_ * segment_;
+        for (size_type first = segment_; first <= last; first += segment_)
+            checkpoints_.emplace_back(net.inner()[first - 1]->osize());
+
+        offsets_.push_back(0);
+        for (size_type i = 0; i < last; ++i)
+        {
+            layer(i).caches(shapes_);
+            offsets_.push_back(shapes_.size());
+
+            if (offsets_[i + 1] - offsets_[i] > width_) width_ = offsets_[i + 1] - offsets_[i];
+        }
+
+        slots_ = segment_ > 2 ? segment_ : 2;
+
+        std::vector<size_type> capacity(slots_ * width_, 0);
+        for (size_type i = 0; i < last; ++i)
+            for (size_type c = offsets_[i]; c < offsets_[i + 1]; ++c)
+            {
+                size_type& size = capacity[i % slots_ * width_ + c - offsets_[i]];
+                if (shapes_[c].size > size) size = shapes_[c].size;
+            }
+
+        buffers_ = Container<Tensor>(capacity.size());
+        for (size_type k = 0; k < capacity.size(); ++k) buffers_[k].resize(1, 1, capacity[k]);
+
+        // own caches of the released layers are freed by swap with empty tensors
+        Container<Tensor> caches(width_);
+        for (size_type i = 0; i < last; ++i)
+        {
+            layer(i).exchange(caches.data());
+            for (auto& cache : caches) cache = Tensor();
+        }
     }
 
+    // Loss MUST be stateless (as all built-in losses are): loss(idata, odata) calls its f()
+    // from many evaluation threads at once
     void loss(ILoss* loss)
     {
         delete loss_;
         loss_ = loss;
     }
 
+    // Snapshot the model after each 'interval' updates, the snapshot will be written
+    // in background while training continues. Pass nullptr to disable.
+    // Extras (e.g. optimizer) are stored after the model, so training can be resumed
+    // with the same state by Checkpoint::load(path, net, extras...). Extras MUST outlive the training
+    template <class... Serializables>
+    void checkpoint(Checkpoint* checkpoint, size_type interval, Serializables&... serializables)
+    {
+        checkpoint_ = checkpoint;
+        checkpoint_interval_ = interval;
+
+        snapshot_ = [this, &serializables...] { checkpoint_->snapshot(net, serializables...); };
+    }
+
     bool update()
     {
         auto& shape = net.inner.back()->osize();
@@ -191,17 +499,20 @@ public:
         return is_changing;
     }
 
+    // Loss function is shared between evaluation threads, see loss(ILoss*)
     double loss(const Container<Tensor>& idata,
-                     const Container<Tensor>& odata) const noexcept
+                const Container<Tensor>& odata) const
     {
-        precision_type result = 0.;
-        precision_type error  = 0.;
+        auto loss = loss_;
 
-        for (size_type i = 0; i < odata.size(); ++i)
+        double result = net.evaluate(idata, 0., [&odata, loss]
+        (double& result, size_type i, const Tensor& prediction)
         {
-            loss_->f(error, odata[i], net.feedforward(idata[i]));
+            precision_type error = 0.;
+
+            loss->f(error, odata[i], prediction);
             result += error;
-        }
+        });
 
         return result / static_cast<double>(odata.size());
     }
@@ -214,10 +525,102 @@ private:
     }
 
 private:
+    const Tensor& boundary(const Tensor& sample, size_type first) const noexcept
+    {
+        return first == 0 ? sample : checkpoints_[first / segment_ - 1];
+    }
+
+    // Give the layer i its set of the planned buffers shaped as its caches
+    void lend(size_type i) noexcept
+    {
+        Tensor* caches = buffers_.data() + i % slots_ * width_;
+        for (size_type c = offsets_[i]; c < offsets_[i + 1]; ++c) caches[c - offsets_[i]].reshape(shapes_[c]);
+
+        layer(i).exchange(caches);
+    }
+
+    // Take the buffers back from the layer i, it keeps empty caches
+    void reclaim(size_type i) noexcept
+    {
+        layer(i).exchange(buffers_.data() + i % slots_ * width_);
+    }
+
+    // Allocate own caches for the layers released by recompute()
+    void restore()
+    {
+        Container<Tensor> caches(width_);
+        for (size_type i = 0; i + 1 < offsets_.size(); ++i)
+        {
+            for (size_type c = offsets_[i]; c < offsets_[i + 1]; ++c)
+                caches[c - offsets_[i]].resize(shapes_[c]).fill(0.f);
+
+            layer(i).exchange(caches.data());
+        }
+    }
+
+    // Backward of the layers [first, last), input is the input of the first of them
+    void backward(const Tensor& input, size_type first, size_type last) noexcept
+    {
+        const size_type N = net.size();
+
+        for (size_type i = last; i-- > first;)
+        {
+            const Tensor& idelta = i + 1 == N ? delta : layer(i + 1).delta();
+            const Tensor& value = i == first ? input : layer(i - 1).value();
+
+            layer(i).backward(value, idelta, i > 0);
+        }
+    }
+
     // only for model
-    void updating(IOptimizer& optimizer, precision_type alpha) noexcept
+    void learning(const Container<Tensor>& idata,
+                  const Container<Tensor>& odata,
+                  size_type first,
+                  size_type last) noexcept
+    {
+        for (size_type sample = first; sample < last; ++sample)
+        {
+            feedforward(idata[sample]);
+            backprop(idata[sample], odata[sample]);
+
+            accumulating();
+        }
+    }
+
+    void learning_subset(const Container<Tensor>& idata,
+                         const Container<Tensor>& odata,
+                         const size_type* indices,
+                         size_type count) noexcept
     {
-        for (size_type i = 0; i < net.size(); ++i) layer(i).update(optimizer, alpha);
+        for (size_type k = 0; k < count; ++k)
+        {
+            feedforward(idata[indices[k]]);
+            backprop(idata[indices[k]], odata[indices[k]]);
+
+            accumulating();
+        }
+    }
+
+    static std::vector<size_type> permutation(size_type size)
+    {
+        std::vector<size_type> order(size);
+        for (size_type i = 0; i < size; ++i) order[i] = i;
+
+        return order;
+    }
+
+    void updating(IOptimizer& optimizer, precision_type alpha)
+    {
+        // one optimizer call for the whole net
+        parameters_.clear();
+        for (size_type i = 0; i < net.size(); ++i) layer(i).parameters(parameters_);
+
+        optimizer.update_all(parameters_.data(), parameters_.size(), alpha);
+        for (size_type i = 0; i < net.size(); ++i) layer(i).synchronize();
+
+        ++step_;
+        if (checkpoint_ != nullptr && checkpoint_interval_ > 0 && step_ % checkpoint_interval_ == 0)
+            snapshot_();
     }
 
     void reseting() noexcept
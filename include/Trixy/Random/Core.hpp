@@ -1,11 +1,15 @@
 #ifndef TRIXY_RANDOM_HPP
 #define TRIXY_RANDOM_HPP
 
+#include <cmath> // sqrt, log, cos, sin
 #include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
 #include <ctime> // time
-#include <random> // srand, rand
+#include <limits> // numeric_limits
+#include <type_traits> // make_unsigned
 
 #include <Trixy/Detail/TrixyMeta.hpp>
+#include <Trixy/Detail/FunctionDetail.hpp>
 #include <Trixy/Detail/MetaMacro.hpp>
 
 namespace trixy
@@ -45,31 +49,287 @@ struct is_floating_random_type<utility::RandomType::Floating<T>> : std::true_typ
 namespace utility
 {
 
-class DefaultGenerator
+namespace detail
+{
+
+inline std::uint64_t rotl(std::uint64_t x, int k) noexcept
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Expand the seed to the generator state
+inline std::uint64_t splitmix64(std::uint64_t& x) noexcept
+{
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+// Uniform value from [0, 1) by the high bits of the random value
+template <typename T>
+T uniform(std::uint64_t x) noexcept
+{
+    return sizeof(T) > sizeof(float)
+         ? static_cast<T>(static_cast<double>(x >> 11) * (1. / 9007199254740992.))  // 2^-53
+         : static_cast<T>(static_cast<float>(x >> 40) * (1.f / 16777216.f));        // 2^-24
+}
+
+} // namespace detail
+
+// xoshiro256++ by D. Blackman and S. Vigna: fast 64 bit generator with period 2^256 - 1.
+// Use jump() or split() to get independent streams, e.g. one per thread
+class Xoshiro256
 {
 public:
+    using result_type = std::uint64_t;
     using size_type = std::size_t;
-    using Generator = int (*)();
+
+private:
+    std::uint64_t state_[4];
 
 public:
-    DefaultGenerator() noexcept
+    explicit Xoshiro256(std::uint64_t seed = 0) noexcept { this->seed(seed); }
+
+    void seed(std::uint64_t seed) noexcept
+    {
+        for (auto& s : state_) s = detail::splitmix64(seed);
+    }
+
+    result_type operator() () noexcept
+    {
+        const std::uint64_t result = detail::rotl(state_[0] + state_[3], 23) + state_[0];
+        const std::uint64_t t = state_[1] << 17;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+
+        state_[2] ^= t;
+        state_[3] = detail::rotl(state_[3], 45);
+
+        return result;
+    }
+
+    // Equivalent to 2^128 calls, generates 2^128 non-overlapping streams
+    void jump() noexcept
+    {
+        static const std::uint64_t polynomial[] =
+        { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+        advance(polynomial);
+    }
+
+    // Equivalent to 2^192 calls, generates 2^64 starting points for the jump() streams
+    void long_jump() noexcept
+    {
+        static const std::uint64_t polynomial[] =
+        { 0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull };
+
+        advance(polynomial);
+    }
+
+    // Return generator with the current state and jump, so streams don't overlap
+    Xoshiro256 split() noexcept
+    {
+        Xoshiro256 stream = *this;
+        jump();
+
+        return stream;
+    }
+
+    // Uniform values from [min, max)
+    template <typename T>
+    void fill(T* first, T* last, T min = T(0), T max = T(1)) noexcept
+    {
+        for (; first != last; ++first) *first = (max - min) * detail::uniform<T>((*this)()) + min;
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+private:
+    void advance(const std::uint64_t (&polynomial)[4]) noexcept
     {
-        std::srand(DefaultGenerator::seed());
+        std::uint64_t s[4] = { 0, 0, 0, 0 };
+
+        for (auto word : polynomial)
+            for (int b = 0; b < 64; ++b)
+            {
+                if (word & (std::uint64_t(1) << b))
+                    for (int i = 0; i < 4; ++i) s[i] ^= state_[i];
+
+                (*this)();
+            }
+
+        for (int i = 0; i < 4; ++i) state_[i] = s[i];
     }
+};
 
-    DefaultGenerator(size_type seed) noexcept { std::srand(seed); }
+// Philox4x32-10 by J. Salmon et al.: counter-based generator, each 128 bit counter is
+// encrypted to 128 random bits independently, so any part of the sequence is computed
+// without the previous ones. Streams are selected by the high half of the counter,
+// fill() is split between threads and doesn't depend on their number.
+// fill() and normal() aren't noexcept, since threads may fail to start
+class Philox
+{
+public:
+    using result_type = std::uint64_t;
+    using size_type = std::size_t;
 
-    void seed(size_type seed) noexcept { std::srand(seed); }
+private:
+    std::uint64_t key_;
+    std::uint64_t stream_;
+    std::uint64_t counter_;         ///< index of the next block in the stream
 
-    int operator() () noexcept { return std::rand(); }
+    std::uint64_t buffer_[2];
+    int position_;                  ///< next unused value of the buffer
+
+public:
+    explicit Philox(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept
+        : key_(seed), stream_(stream), counter_(0), buffer_(), position_(2)
+    {
+    }
+
+    void seed(std::uint64_t seed) noexcept
+    {
+        key_ = seed;
+        counter_ = 0;
+        position_ = 2;
+    }
+
+    result_type operator() () noexcept
+    {
+        if (position_ == 2)
+        {
+            block(counter_++, buffer_);
+            position_ = 0;
+        }
+
+        return buffer_[position_++];
+    }
+
+    // Skip n blocks of two values
+    void discard(std::uint64_t n) noexcept
+    {
+        counter_ += n;
+        position_ = 2;
+    }
+
+    // Independent stream with the same seed
+    Philox split(std::uint64_t stream) const noexcept
+    {
+        return Philox(key_, stream);
+    }
+
+    std::uint64_t stream() const noexcept { return stream_; }
+
+    // Two random values of the block with the index of the current stream
+    void block(std::uint64_t index, std::uint64_t (&out)[2]) const noexcept
+    {
+        std::uint32_t c[4] = {
+            static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+            static_cast<std::uint32_t>(stream_), static_cast<std::uint32_t>(stream_ >> 32)
+        };
+
+        std::uint32_t k0 = static_cast<std::uint32_t>(key_);
+        std::uint32_t k1 = static_cast<std::uint32_t>(key_ >> 32);
+
+        for (int round = 0; round < 10; ++round)
+        {
+            const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c[0];
+            const std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+
+            const std::uint32_t x0 = static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            const std::uint32_t x2 = static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+
+            c[0] = x0;
+            c[1] = static_cast<std::uint32_t>(p1);
+            c[2] = x2;
+            c[3] = static_cast<std::uint32_t>(p0);
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        out[0] = std::uint64_t(c[0]) | (std::uint64_t(c[1]) << 32);
+        out[1] = std::uint64_t(c[2]) | (std::uint64_t(c[3]) << 32);
+    }
+
+    // Uniform values from [min, max), blocks of the sequence are generated in parallel
+    template <typename T>
+    void fill(T* first, T* last, T min = T(0), T max = T(1))
+    {
+        const T range = max - min;
+
+        generate(first, last, [range, min](const std::uint64_t (&block)[2], T* out, size_type count)
+        {
+            out[0] = range * detail::uniform<T>(block[0]) + min;
+            if (count > 1) out[1] = range * detail::uniform<T>(block[1]) + min;
+        });
+    }
+
+    // Normal values by the Box-Muller transform of each block
+    template <typename T>
+    void normal(T* first, T* last, T mean = T(0), T std = T(1))
+    {
+        generate(first, last, [mean, std](const std::uint64_t (&block)[2], T* out, size_type count)
+        {
+            const double radius = std::sqrt(-2. * std::log(1. - detail::uniform<double>(block[0])));
+            const double angle = 6.283185307179586 * detail::uniform<double>(block[1]);
+
+            out[0] = static_cast<T>(radius * std::cos(angle)) * std + mean;
+            if (count > 1) out[1] = static_cast<T>(radius * std::sin(angle)) * std + mean;
+        });
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+private:
+    // Each block of two values is converted by function(block, out, count), count <= 2
+    template <typename T, class Function>
+    void generate(T* first, T* last, Function function)
+    {
+        const size_type size = static_cast<size_type>(last - first);
+        const size_type blocks = (size + 1) / 2;
+
+        const std::uint64_t counter = counter_;
+
+        trixy::detail::parallel_for(
+            trixy::detail::parallel_info<2048>(blocks), blocks,
+            [this, first, size, counter, &function](size_type i, size_type n, size_type)
+            {
+                std::uint64_t values[2];
+
+                for (; i < n; ++i)
+                {
+                    block(counter + i, values);
+                    function(values, first + 2 * i, size - 2 * i);
+                }
+            }
+        );
+
+        discard(blocks);
+    }
+};
+
+// Generator with the time based seed by default
+class DefaultGenerator : public Xoshiro256
+{
+public:
+    using Xoshiro256::seed;
+
+public:
+    DefaultGenerator() noexcept : Xoshiro256(DefaultGenerator::seed()) {}
+    DefaultGenerator(size_type seed) noexcept : Xoshiro256(seed) {}
 
     static std::size_t seed() noexcept
     {
         return static_cast<std::size_t>(std::time(nullptr));
     }
-
-    static constexpr int min() noexcept { return 0; }
-    static constexpr int max() noexcept { return RAND_MAX; }
 };
 
 template <typename RandomType, class Generator = DefaultGenerator, typename enable = void>
@@ -93,14 +353,18 @@ public:
 
     void seed(size_type seed) noexcept { gen.seed(seed); }
 
+    // Non-negative value
     integral_type operator() () noexcept
     {
-        return static_cast<integral_type>(gen());
+        return static_cast<integral_type>(gen() & std::numeric_limits<integral_type>::max());
     }
 
     integral_type operator() (integral_type min, integral_type max) noexcept
     {
-        return (*this)() % (max - min + 1) + min;
+        using unsigned_type = typename std::make_unsigned<integral_type>::type;
+
+        const unsigned_type range = static_cast<unsigned_type>(max) - static_cast<unsigned_type>(min) + 1;
+        return static_cast<integral_type>(static_cast<unsigned_type>(gen()) % range + static_cast<unsigned_type>(min));
     }
 };
 
@@ -33,6 +33,8 @@ protected:
     using require::tensordot;
     using require::transpose;
     using require::inverse;
+    using require::solve;
+    using require::solve_spd;
 
     using require::add;
     using require::sub;
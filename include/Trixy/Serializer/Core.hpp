@@ -7,6 +7,8 @@
 #include <SF/Utility/Span.hpp>
 #include <SF/BuiltIn/vector.hpp>
 
+#include <Trixy/Serializer/Mapping.hpp>
+
 namespace trixy
 {
 
@@ -0,0 +1,220 @@
+#ifndef TRIXY_SERIALIZER_MAPPING_HPP
+#define TRIXY_SERIALIZER_MAPPING_HPP
+
+#include <cstddef> // size_t
+#include <cstring> // memcpy
+#include <fstream> // ifstream
+#include <memory> // shared_ptr
+#include <type_traits> // true_type, false_type
+#include <utility> // pair
+#include <vector> // vector
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define TRIXY_MAPPING_POSIX
+    #include <fcntl.h> // open
+    #include <sys/mman.h> // mmap, munmap
+    #include <sys/stat.h> // fstat
+    #include <unistd.h> // close
+#endif // defined(__unix__) || defined(__APPLE__)
+
+namespace trixy
+{
+
+namespace memory
+{
+
+// View of the whole file, pages are mapped privately (copy on write),
+// so many processes share them until somebody writes, writes never reach the file.
+// On platforms without mmap the file will be read into the heap buffer
+class MappedFile
+{
+public:
+    using byte_type = unsigned char;
+    using size_type = std::size_t;
+
+private:
+    byte_type* data_;
+    size_type size_;
+
+    bool mapped_;
+
+public:
+    explicit MappedFile(const char* path) : data_(nullptr), size_(0), mapped_(false)
+    {
+    #ifdef TRIXY_MAPPING_POSIX
+        int fd = ::open(path, O_RDONLY);
+        if (fd != -1)
+        {
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* memory = ::mmap(nullptr, static_cast<size_type>(info.st_size),
+                                      PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+                if (memory != MAP_FAILED)
+                {
+                    data_ = static_cast<byte_type*>(memory);
+                    size_ = static_cast<size_type>(info.st_size);
+                    mapped_ = true;
+                }
+            }
+
+            ::close(fd);
+        }
+
+        if (mapped_) return;
+    #endif // TRIXY_MAPPING_POSIX
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (not file.is_open()) return;
+
+        const auto size = static_cast<size_type>(file.tellg());
+        if (size == 0) return;
+
+        data_ = new byte_type [size];
+        size_ = size;
+
+        file.seekg(0);
+        if (not file.read(reinterpret_cast<char*>(data_), size))
+        {
+            delete[] data_;
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    ~MappedFile()
+    {
+    #ifdef TRIXY_MAPPING_POSIX
+        if (mapped_)
+        {
+            ::munmap(data_, size_);
+            return;
+        }
+    #endif // TRIXY_MAPPING_POSIX
+
+        delete[] data_;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    bool is_open() const noexcept { return data_ != nullptr; }
+    bool is_mapped() const noexcept { return mapped_; }
+
+    byte_type* data() const noexcept { return data_; }
+    size_type size() const noexcept { return size_; }
+};
+
+// Thread local context of the mapped model (de)serialization.
+// While it is active, tensors keep only their shape in the archive, and their data
+// goes to the aligned blobs: on saving, blobs are collected for the writer,
+// on loading, view tensors refer to the blobs directly and own tensors copy them
+class MappingScope
+{
+public:
+    using byte_type = unsigned char;
+    using size_type = std::size_t;
+
+    using Blob = std::pair<const byte_type*, size_type>;
+
+    static constexpr size_type alignment = 64; ///< alignment of each blob in the file
+
+private:
+    MappingScope* previous_;
+
+    std::vector<Blob> blobs_;
+
+    byte_type* data_;
+    size_type size_;
+    size_type offset_;
+
+    std::shared_ptr<void> keepalive_;
+
+    bool fail_;
+
+public:
+    // Saving scope
+    MappingScope()
+        : previous_(current()), data_(nullptr), size_(0), offset_(0), fail_(false)
+    {
+        current() = this;
+    }
+
+    // Loading scope, keepalive will be shared with all objects which refer to the data
+    MappingScope(byte_type* data, size_type size, std::shared_ptr<void> keepalive)
+        : previous_(current()), data_(data), size_(size), offset_(0)
+        , keepalive_(std::move(keepalive)), fail_(false)
+    {
+        current() = this;
+    }
+
+    ~MappingScope() { current() = previous_; }
+
+    MappingScope(const MappingScope&) = delete;
+    MappingScope& operator= (const MappingScope&) = delete;
+
+    static MappingScope*& current() noexcept
+    {
+        static thread_local MappingScope* scope = nullptr;
+        return scope;
+    }
+
+    static size_type align(size_type size) noexcept
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    template <typename T>
+    void save(const T* data, size_type size)
+    {
+        blobs_.emplace_back(reinterpret_cast<const byte_type*>(data), size * sizeof(T));
+    }
+
+    // view tensor
+    template <typename T>
+    void load(T*& data, size_type size, std::true_type) noexcept
+    {
+        data = next<T>(size);
+    }
+
+    // own tensor
+    template <typename T>
+    void load(T*& data, size_type size, std::false_type)
+    {
+        delete[] data;
+        data = new T [size];
+
+        const T* blob = next<T>(size);
+        if (blob != nullptr) std::memcpy(data, blob, size * sizeof(T));
+    }
+
+    const std::vector<Blob>& blobs() const noexcept { return blobs_; }
+    const std::shared_ptr<void>& keepalive() const noexcept { return keepalive_; }
+
+    bool fail() const noexcept { return fail_; }
+
+private:
+    template <typename T>
+    T* next(size_type size) noexcept
+    {
+        const size_type bytes = size * sizeof(T);
+
+        if (bytes > size_ || offset_ > size_ - bytes)
+        {
+            fail_ = true;
+            return nullptr;
+        }
+
+        T* data = reinterpret_cast<T*>(data_ + offset_);
+        offset_ = align(offset_ + bytes);
+
+        return data;
+    }
+};
+
+} // namespace memory
+
+} // namespace trixy
+
+#endif // TRIXY_SERIALIZER_MAPPING_HPP
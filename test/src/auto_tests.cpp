@@ -7,6 +7,11 @@
 using Core = trixy::TypeSet<float>;
 using Net = trixy::TrixyNet<Core>;
 
+bool is_near(double a, double b)
+{
+    return std::fabs(a - b) < 1.e-6;
+}
+
 TEST(TestLique, TestMatrix)
 {
     {
@@ -47,6 +52,236 @@ TEST(TestLique, TestTensor)
     }
 }
 
+TEST(TestLique, TestReduction)
+{
+    {
+        Core::Matrix x(3, 4);
+        x.copy({
+            0, 7, 2, 3,
+            4, 5, 6, 3,
+            8, 1, 6, 11
+        });
+
+        auto argmax_x = trixy::lique::argmax(x, trixy::lique::Axis::X);
+        auto argmin_y = trixy::lique::argmin(x, trixy::lique::Axis::Y);
+
+        EXPECT("argmax", argmax_x(0) == 2 && argmax_x(1) == 0 && argmax_x(2) == 1 && argmax_x(3) == 2);
+        EXPECT("argmin", argmin_y(0) == 0 && argmin_y(1) == 3 && argmin_y(2) == 1);
+
+        auto sum_y = trixy::lique::sum(x, trixy::lique::Axis::Y);
+        auto mean_x = trixy::lique::mean(x, trixy::lique::Axis::X);
+        auto std_x = trixy::lique::std(x, trixy::lique::Axis::X);
+
+        EXPECT("sum", sum_y(0) == 12. && sum_y(1) == 18. && sum_y(2) == 26.);
+        EXPECT("mean", is_near(mean_x(0), 4.) && is_near(mean_x(1), 13. / 3.) && is_near(mean_x(3), 17. / 3.));
+        EXPECT("std", is_near(std_x(0), std::sqrt(32. / 3.)) && is_near(std_x(2), std::sqrt(32. / 9.)));
+    }
+    {
+        // large enough to be split between threads
+        const Core::size_type height = 4099;
+        const Core::size_type width = 300;
+
+        Core::Matrix x(height, width);
+        for (Core::size_type i = 0; i < height; ++i)
+            for (Core::size_type j = 0; j < width; ++j)
+                x(i, j) = static_cast<float>((i * 31 + j * 17) % 101) + 1000.f;
+
+        trixy::lique::Vector<double> mean, variance;
+        trixy::lique::moments(x, trixy::lique::Axis::X, mean, variance, true);
+
+        auto argmax_x = trixy::lique::argmax(x, trixy::lique::Axis::X);
+
+        bool is_correct = true;
+        for (Core::size_type j = 0; j < width; ++j)
+        {
+            double m = 0.;
+            Core::size_type arg = 0;
+
+            for (Core::size_type i = 0; i < height; ++i)
+            {
+                m += x(i, j);
+                if (x(arg, j) < x(i, j)) arg = i;
+            }
+
+            m /= height;
+
+            double v = 0.;
+            for (Core::size_type i = 0; i < height; ++i) v += (x(i, j) - m) * (x(i, j) - m);
+
+            v /= height - 1;
+
+            is_correct = is_correct && is_near(mean(j), m) && std::fabs(variance(j) - v) < 1e-6 * v
+                                    && argmax_x(j) == arg;
+        }
+
+        EXPECT("parallel", is_correct);
+    }
+}
+
+TEST(TestLique, TestSolve)
+{
+    using Matrix = trixy::lique::Matrix<double>;
+    using Vector = trixy::lique::Vector<double>;
+
+    trixy::lique::Linear<double> linear;
+
+    {
+        // larger than one panel, so the blocked update is used
+        const Core::size_type N = 150;
+
+        Matrix a(N, N);
+        for (Core::size_type i = 0; i < N; ++i)
+            for (Core::size_type j = 0; j < N; ++j)
+                a(i, j) = static_cast<double>((i * 37 + j * 11) % 23) - 11. + (i == j ? 3. : 0.);
+
+        Matrix b(N, 2);
+        for (Core::size_type i = 0; i < N; ++i)
+        {
+            b(i, 0) = static_cast<double>(i % 7);
+            b(i, 1) = 1.;
+        }
+
+        Matrix factorization(a.shape());
+        factorization.copy(a);
+
+        Matrix x(N, 2);
+        bool is_solved = linear.solve(x, factorization, b);
+
+        double error = 0.;
+        for (Core::size_type i = 0; i < N; ++i)
+            for (Core::size_type c = 0; c < 2; ++c)
+            {
+                double value = 0.;
+                for (Core::size_type k = 0; k < N; ++k) value += a(i, k) * x(k, c);
+
+                error = std::max(error, std::fabs(value - b(i, c)));
+            }
+
+        EXPECT("lu", is_solved && error < 1e-8);
+    }
+    {
+        const Core::size_type N = 130;
+
+        Matrix m(N, N);
+        for (Core::size_type i = 0; i < N; ++i)
+            for (Core::size_type j = 0; j < N; ++j)
+                m(i, j) = static_cast<double>((i * 13 + j * 7) % 17) / 17.;
+
+        // a = m . m^T + I is positive definite
+        Matrix a(N, N);
+        for (Core::size_type i = 0; i < N; ++i)
+            for (Core::size_type j = 0; j < N; ++j)
+            {
+                double value = i == j ? 1. : 0.;
+                for (Core::size_type k = 0; k < N; ++k) value += m(i, k) * m(j, k);
+
+                a(i, j) = value;
+            }
+
+        Vector b(N);
+        for (Core::size_type i = 0; i < N; ++i) b(i) = static_cast<double>(i % 5) - 2.;
+
+        Matrix factorization(a.shape());
+        factorization.copy(a);
+
+        Vector x(N);
+        bool is_solved = linear.solve_spd(x, factorization, b);
+
+        double error = 0.;
+        for (Core::size_type i = 0; i < N; ++i)
+        {
+            double value = 0.;
+            for (Core::size_type k = 0; k < N; ++k) value += a(i, k) * x(k);
+
+            error = std::max(error, std::fabs(value - b(i)));
+        }
+
+        EXPECT("cholesky", is_solved && error < 1e-8 && factorization(0, 1) == 0.);
+    }
+    {
+        Matrix singular(3, 3);
+        singular.copy({ 1., 2., 3., 2., 4., 6., 1., 0., 1. });
+
+        Matrix indefinite(2, 2);
+        indefinite.copy({ 1., 2., 2., 1. });
+
+        Vector b(3), x(3);
+        b.fill(1.);
+
+        std::size_t pivots[2];
+        Matrix copy(indefinite.shape());
+        copy.copy(indefinite);
+
+        EXPECT("singular", not linear.solve(x, singular, b) && not linear.cholesky(indefinite) &&
+                           linear.lu(copy, pivots));
+    }
+    {
+        using PolynomialRegression = trixy::PolynomialRegression<trixy::TypeSet<double>>;
+
+        PolynomialRegression reg(5);
+        trixy::train::Training<PolynomialRegression> teach(reg);
+
+        Vector idata(200), odata(200);
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            const double x = static_cast<double>(i) / 20. - 5.;
+
+            idata(i) = x;
+            odata(i) = 1. - 2. * x + 0.5 * x * x * x - 0.01 * x * x * x * x * x;
+        }
+
+        teach.train(idata, odata);
+
+        const auto& W = reg.weight();
+
+        EXPECT("regression", std::fabs(W(0) - 1.) < 1e-6 && std::fabs(W(1) + 2.) < 1e-6 &&
+                             std::fabs(W(3) - 0.5) < 1e-6 && std::fabs(W(5) + 0.01) < 1e-8);
+
+        // the same fit by chunks
+        PolynomialRegression streamed(5);
+        trixy::train::Training<PolynomialRegression> streamed_teach(streamed);
+
+        for (Core::size_type first = 0; first < idata.size(); first += 64)
+        {
+            const Core::size_type count = std::min<Core::size_type>(64, idata.size() - first);
+
+            streamed_teach.accumulate(Vector(idata.data() + first, idata.data() + first + count),
+                                      Vector(odata.data() + first, odata.data() + first + count));
+        }
+
+        bool is_streamed = streamed_teach.fit();
+        for (Core::size_type j = 0; j < W.size(); ++j)
+            is_streamed = is_streamed && std::fabs(streamed.weight()(j) - W(j)) < 1e-9;
+
+        EXPECT("streaming", is_streamed);
+    }
+    {
+        using LinearRegression = trixy::LinearRegression<trixy::TypeSet<double>>;
+
+        // large enough to be split between threads
+        const Core::size_type size = 40000;
+
+        Matrix idata(size, 2);
+        Vector odata(size);
+
+        for (Core::size_type i = 0; i < size; ++i)
+        {
+            idata(i, 0) = static_cast<double>(i % 101) / 100.;
+            idata(i, 1) = static_cast<double>(i % 37) / 36.;
+
+            odata(i) = 0.25 + 2. * idata(i, 0) - 3. * idata(i, 1);
+        }
+
+        LinearRegression reg(2);
+        trixy::train::Training<LinearRegression> teach(reg);
+
+        const auto& W = reg.weight();
+
+        EXPECT("linear", teach.train(idata, odata) && std::fabs(W(0) - 0.25) < 1e-9 &&
+                         std::fabs(W(1) - 2.) < 1e-9 && std::fabs(W(2) + 3.) < 1e-9);
+    }
+}
+
 using trixy::set::Input;
 using trixy::set::Output;
 
@@ -59,9 +294,42 @@ using FullyConnected = trixy::layer::FullyConnected<Net>;
 
 using ReLU = trixy::functional::activation::ReLU<Core::precision_type>;
 
-bool is_near(double a, double b)
+using Random = trixy::utility::RandomFloating<float, trixy::utility::Xoshiro256>;
+
+// Deterministic uniform values in [min, max), copies share the generator, so it can be passed by value
+class Uniform
 {
-    return std::fabs(a - b) < 1.e-6;
+private:
+    std::shared_ptr<Random> random_;
+
+    float min_;
+    float max_;
+
+public:
+    explicit Uniform(Core::size_type seed, float min = -1.f, float max = 1.f)
+        : random_(std::make_shared<Random>(seed)), min_(min), max_(max)
+    {
+    }
+
+    float operator() () const noexcept { return (*random_)(min_, max_); }
+};
+
+// Fully connected net with ReLU between the layers, its weights depend only on the seed
+std::unique_ptr<Net> make_net(std::initializer_list<Core::size_type> sizes, Core::size_type seed)
+{
+    std::unique_ptr<Net> net(new Net);
+
+    for (auto size = sizes.begin(); size + 1 != sizes.end(); ++size)
+    {
+        if (size + 2 != sizes.end())
+            net->add(new FullyConnected(size[0], size[1], new ReLU));
+        else
+            net->add(new FullyConnected(size[0], size[1]));
+    }
+
+    net->init(Uniform(seed, -0.5f, 0.5f));
+
+    return net;
 }
 
 TEST(TestNeuro, TestFullyConnected)
@@ -261,3 +529,1751 @@ TEST(TestNeuro, TestMaxPooling)
         );
     }
 }
+
+using MaxPooling = trixy::layer::MaxPooling<Net>;
+
+TEST(TestNeuro, TestTrainMaxPooling)
+{
+    {
+        Core::Tensor input(1, 4, 4);
+        input.copy({
+            -4, -3,  1,  2,
+            -2, -1,  3,  5,
+             6,  0, -5, -6,
+             7,  8, -7, -8
+        });
+
+        // without activation the value is the pooled maximum, as for the raw layer
+        MaxPooling identity(Input(1, 4, 4), Stride(2));
+        identity.forward(input);
+
+        auto& x = identity.value();
+
+        EXPECT("value identity",
+            x(0, 0, 0) == -1 && x(0, 0, 1) == 5 && x(0, 1, 0) == 8 && x(0, 1, 1) == -5
+        );
+
+        // activation is applied to the pooled maximum, not to the previous buffer
+        MaxPooling relu(Input(1, 4, 4), Stride(2), new ReLU);
+        relu.forward(input);
+
+        auto& y = relu.value();
+
+        EXPECT("value activation",
+            y(0, 0, 0) == 0 && y(0, 0, 1) == 5 && y(0, 1, 0) == 8 && y(0, 1, 1) == 0
+        );
+
+        // delta goes to the maximum through derivative at the pooled value
+        Core::Tensor idelta(1, 2, 2);
+        idelta.fill(1.f);
+
+        relu.backward(input, idelta);
+
+        auto& delta = relu.delta();
+
+        float sum = 0.f;
+        for (Core::size_type i = 0; i < delta.size(); ++i) sum += delta.data()[i];
+
+        EXPECT("delta", delta(0, 1, 3) == 1 && delta(0, 3, 1) == 1 && delta(0, 1, 1) == 0 && sum == 2);
+    }
+}
+
+using SoftmaxCrossEntropy = trixy::functional::loss::SoftmaxCrossEntropy<Core::precision_type>;
+
+TEST(TestFunctional, TestSoftmaxCrossEntropy)
+{
+    {
+        SoftmaxCrossEntropy loss;
+
+        Core::Tensor target(1, 1, 3);
+        target.copy({ 0, 0, 1 });
+
+        Core::Tensor logits(1, 1, 3);
+        logits.copy({ 1, 2, 3 });
+
+        Core::precision_type result;
+        loss.f(result, target, logits);
+
+        EXPECT("value", is_near(result, 0.40760596));
+
+        // shifted logits must not overflow
+        logits.copy({ 1001, 1002, 1003 });
+        loss.f(result, target, logits);
+
+        EXPECT("value stable", is_near(result, 0.40760596));
+
+        Core::Tensor delta(1, 1, 3);
+        loss.df(delta, target, logits);
+
+        EXPECT("delta",
+            is_near(delta(0), 0.09003057) &&
+            is_near(delta(1), 0.24472847) &&
+            is_near(delta(2), -0.33475904)
+        );
+    }
+    {
+        SoftmaxCrossEntropy loss;
+
+        Core::Tensor target(1, 2, 3);
+        target.copy({
+            0, 0, 1,
+            1, 0, 0
+        });
+
+        Core::Tensor logits(1, 2, 3);
+        logits.copy({
+            1, 2, 3,
+            0, 0, 0
+        });
+
+        // (0.40760596 + log(3)) / 2
+        EXPECT("batch", is_near(loss.batch(target, logits, 3), 0.75310913));
+        EXPECT("no classes", loss.batch(target, logits, 0) == 0.f);
+    }
+}
+
+using MSE = trixy::functional::loss::MSE<Core::precision_type>;
+
+TEST(TestNeuro, TestEvaluate)
+{
+    {
+        Net net;
+        net.add(new FullyConnected(4, 8, new ReLU))
+           .add(new FullyConnected(8, 3));
+
+        net.init(Uniform(1, -0.5f, 0.5f));
+
+        Core::Container<Core::Tensor> idata(500);
+        Core::Container<Core::Tensor> odata(500);
+
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            idata[i].resize(1, 1, 4).fill(static_cast<float>(i % 7) / 7.f);
+            odata[i].resize(1, 1, 3).fill(0.f);
+            odata[i](i % 3) = 1.f;
+        }
+
+        double expected_loss = 0.;
+        Core::size_type expected_count = 0;
+
+        MSE loss;
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            Core::precision_type error = 0.;
+            loss(error, odata[i], net.feedforward(idata[i]));
+
+            expected_loss += error;
+            expected_count += trixy::Accuracy<Net>::Guide::normal(odata[i], net.feedforward(idata[i]));
+        }
+
+        trixy::Checker<Net> check(net);
+
+        EXPECT("loss", is_near(check.loss(idata, odata, MSE()), expected_loss / idata.size()));
+        EXPECT("accuracy", check.accuracy(idata, odata) == static_cast<double>(expected_count) / idata.size());
+
+        auto metrics = check.metrics(idata, odata, MSE());
+
+        EXPECT("metrics", metrics.count() == idata.size() &&
+                          metrics.accuracy() == static_cast<double>(expected_count) / idata.size() &&
+                          is_near(metrics.loss(), expected_loss / idata.size()));
+    }
+}
+
+TEST(TestNeuro, TestMetrics)
+{
+    {
+        trixy::Metrics<Net> metrics(3, 2);
+
+        Core::Tensor target(1, 2, 3);
+        target.copy({
+            0, 0, 1,
+            1, 0, 0
+        });
+
+        Core::Tensor prediction(1, 2, 3);
+        prediction.copy({
+            0.1f, 0.2f, 0.7f,
+            0.3f, 0.5f, 0.2f
+        });
+
+        metrics.update_batch(target, prediction);
+
+        trixy::Metrics<Net> empty(0);
+        empty.update_batch(target, prediction);
+
+        EXPECT("no classes", empty.count() == 0);
+
+        trixy::Metrics<Net> other(3, 2);
+
+        Core::Tensor sample_target(1, 1, 3);
+        sample_target.copy({ 0, 1, 0 });
+
+        Core::Tensor sample_prediction(1, 1, 3);
+        sample_prediction.copy({ 0.6f, 0.1f, 0.3f });
+
+        other.update(sample_target, sample_prediction, 2.f);
+
+        metrics += other;
+
+        EXPECT("count", metrics.count() == 3);
+        EXPECT("confusion",
+            metrics.confusion(2, 2) == 1 && metrics.confusion(0, 1) == 1 && metrics.confusion(1, 0) == 1
+        );
+        EXPECT("accuracy", is_near(metrics.accuracy(), 1. / 3.));
+        EXPECT("top k accuracy", is_near(metrics.top_k_accuracy(), 2. / 3.));
+        EXPECT("precision", is_near(metrics.precision(2), 1.) && is_near(metrics.precision(0), 0.));
+        EXPECT("recall", is_near(metrics.recall(2), 1.) && is_near(metrics.recall(1), 0.));
+        EXPECT("loss", is_near(metrics.loss(), 2. / 3.));
+    }
+}
+
+TEST(TestNeuro, TestCheckpoint)
+{
+    {
+        Net net;
+        net.add(new FullyConnected(4, 4, new ReLU))
+           .add(new FullyConnected(4, 3));
+
+        net.init([] { return 0.1f; });
+
+        Core::Container<Core::Tensor> idata(8);
+        Core::Container<Core::Tensor> odata(8);
+
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            idata[i].resize(1, 1, 4).fill(static_cast<float>(i) / 8.f);
+            odata[i].resize(1, 1, 3).fill(0.f);
+            odata[i](i % 3) = 1.f;
+        }
+
+        auto exists = [](const std::string& path) { return std::ifstream(path).is_open(); };
+
+        {
+            trixy::Checkpoint<Net> checkpoint("auto_test_checkpoint", 1);
+
+            trixy::train::Training<Net> teach(net);
+            teach.loss(new MSE);
+
+            auto optimizer = trixy::train::MomentumOptimizer(net, 0.1f);
+            teach.checkpoint(&checkpoint, 2, optimizer);
+
+            // 4 updates -> 2 snapshots
+            teach.mini_batch(idata, odata, optimizer, 1, 2);
+            checkpoint.wait();
+
+            EXPECT("status", not checkpoint.fail());
+            EXPECT("last", checkpoint.last() == "auto_test_checkpoint.000002.bin");
+            EXPECT("retention",
+                exists("auto_test_checkpoint.000002.bin") && not exists("auto_test_checkpoint.000001.bin")
+            );
+            EXPECT("rename", not exists("auto_test_checkpoint.000002.bin.tmp"));
+        }
+
+        // resumed job continues the numbering of the previous run
+        {
+            trixy::Checkpoint<Net> checkpoint("auto_test_checkpoint", 1);
+
+            EXPECT("resume", checkpoint.last() == "auto_test_checkpoint.000002.bin");
+
+            auto optimizer = trixy::train::MomentumOptimizer(net, 0.1f);
+
+            checkpoint.snapshot(net, optimizer);
+            checkpoint.wait();
+
+            EXPECT("resume index",
+                checkpoint.last() == "auto_test_checkpoint.000003.bin" && not exists("auto_test_checkpoint.000002.bin")
+            );
+        }
+
+        std::remove("auto_test_checkpoint.000003.bin");
+    }
+}
+
+TEST(TestNeuro, TestMappedSerializer)
+{
+    sf::serializable<XConvolutional>();
+    sf::serializable<XMaxPooling>();
+    sf::serializable<FullyConnected>();
+    sf::serializable<ReLU>();
+    sf::serializable<trixy::functional::activation::Identity<Core::precision_type>>();
+
+    Uniform random(5);
+
+    // raw layers refer to the mapped blobs, train layers copy them
+    Net net;
+    net.add(new XConvolutional(Input(2, 6, 6), Filter(3, 3, 3), Padding(1)))
+       .add(new XMaxPooling(Input(3, 6, 6), Stride(2), new ReLU))
+       .add(new FullyConnected(27, 4));
+
+    net.init([&random] { return random(); });
+
+    Core::Container<Core::Tensor> images(4);
+    for (auto& image : images) image.resize(Input(2, 6, 6)).fill(random);
+
+    Core::Container<Core::Tensor> expected;
+    for (const auto& image : images) expected.emplace_back(net.feedforward(image));
+
+    {
+        std::ofstream file("auto_test_model.map", std::ios::binary);
+        trixy::MappedSerializer<Net>::serialize(file, net);
+    }
+
+    {
+        Net loaded;
+        EXPECT("deserialize", trixy::MappedSerializer<Net>::deserialize("auto_test_model.map", loaded));
+
+        bool is_same = loaded.size() == net.size();
+        for (Core::size_type i = 0; i < images.size() && is_same; ++i)
+        {
+            const auto& y = loaded.feedforward(images[i]);
+
+            is_same = y.size() == expected[i].size();
+            for (Core::size_type j = 0; j < y.size() && is_same; ++j) is_same = y(j) == expected[i](j);
+        }
+
+        EXPECT("value", is_same);
+    }
+
+    // header which points out of the file
+    {
+        std::fstream file("auto_test_model.map", std::ios::binary | std::ios::in | std::ios::out);
+
+        const std::uint64_t blob_offset = ~std::uint64_t(0);
+        file.seekp(offsetof(trixy::MappedSerializer<Net>::Header, blob_offset));
+        file.write(reinterpret_cast<const char*>(&blob_offset), sizeof(blob_offset));
+    }
+
+    Net broken;
+    EXPECT("bounds", not trixy::MappedSerializer<Net>::deserialize("auto_test_model.map", broken));
+
+    std::remove("auto_test_model.map");
+}
+
+using Normalizer = trixy::data::Normalizer<Core>;
+
+TEST(TestData, TestNormalizer)
+{
+    {
+        Core::Container<Core::Tensor> samples(1000);
+        for (Core::size_type i = 0; i < samples.size(); ++i)
+        {
+            samples[i].resize(1, 1, 3);
+            samples[i](0) = static_cast<float>(i % 17) + 1000.f;
+            samples[i](1) = static_cast<float>((i * 7) % 5) * 0.25f;
+            samples[i](2) = 3.f;
+        }
+
+        double mean[3] = {};
+        double variance[3] = {};
+
+        for (const auto& sample : samples)
+            for (Core::size_type j = 0; j < 3; ++j) mean[j] += static_cast<double>(sample(j)) / samples.size();
+
+        for (const auto& sample : samples)
+            for (Core::size_type j = 0; j < 3; ++j)
+                variance[j] += (sample(j) - mean[j]) * (sample(j) - mean[j]) / samples.size();
+
+        Normalizer chunked(3);
+        chunked.fit(samples, 128);
+
+        EXPECT("count", chunked.count() == samples.size());
+        EXPECT("mean", is_near(chunked.mean()(0), mean[0]) && is_near(chunked.mean()(1), mean[1]));
+        EXPECT("std", is_near(chunked.std(0), std::sqrt(variance[0])) && chunked.std(2) == 0.);
+
+        // merge of two streaming parts
+        Normalizer first(3), second(3);
+        for (Core::size_type i = 0; i < samples.size(); ++i)
+            (i < 300 ? first : second).update(samples[i]);
+
+        first += second;
+
+        EXPECT("merge", is_near(first.mean()(0), mean[0]) && is_near(first.variance(1), variance[1]));
+
+        // merge refreshes scales of the streaming parts, single samples need finalize()
+        Normalizer streamed(3);
+        for (const auto& sample : samples) streamed.update(sample);
+
+        streamed.finalize();
+
+        Core::Tensor x = samples[1];
+        Core::Tensor y = samples[1];
+        Core::Tensor z = samples[1];
+
+        first.transform(x);
+        chunked.transform(y);
+        streamed.transform(z);
+
+        EXPECT("merge scale", std::fabs(x(0) - y(0)) < 1e-4f && std::fabs(x(1) - y(1)) < 1e-4f);
+        EXPECT("finalize", std::fabs(z(0) - y(0)) < 1e-4f && std::fabs(z(1) - y(1)) < 1e-4f);
+
+        chunked.transform(samples);
+
+        double transformed_mean = 0.;
+        double transformed_square = 0.;
+
+        for (const auto& sample : samples)
+        {
+            transformed_mean += static_cast<double>(sample(0)) / samples.size();
+            transformed_square += static_cast<double>(sample(0)) * sample(0) / samples.size();
+        }
+
+        EXPECT("transform",
+            std::fabs(transformed_mean) < 1e-3 && std::fabs(transformed_square - 1.) < 1e-3 && samples[0](2) == 0.f
+        );
+    }
+}
+
+TEST(TestData, TestIdxFile)
+{
+    {
+        const unsigned char images[] = {
+            0x00, 0x00, 0x08, 0x03,  0x00, 0x00, 0x00, 0x03,  0x00, 0x00, 0x00, 0x02,  0x00, 0x00, 0x00, 0x02,
+            0, 255, 51, 102,
+            1, 2, 3, 4,
+            10, 20, 30, 40
+        };
+
+        const unsigned char labels[] = {
+            0x00, 0x00, 0x08, 0x01,  0x00, 0x00, 0x00, 0x03,
+            2, 0, 1
+        };
+
+        std::ofstream("auto_test_images.idx", std::ios::binary).write(reinterpret_cast<const char*>(images), sizeof(images));
+        std::ofstream("auto_test_labels.idx", std::ios::binary).write(reinterpret_cast<const char*>(labels), sizeof(labels));
+
+        {
+            auto image_file = trixy::data::IdxFile("auto_test_images.idx").dequantize(1. / 255.);
+            auto label_file = trixy::data::IdxFile("auto_test_labels.idx").one_hot(3);
+
+            EXPECT("header",
+                image_file.is_open() && image_file.size() == 3 && image_file.sample_size() == 4 &&
+                image_file.dims().size() == 3 && label_file.is_open() && label_file.features() == 3
+            );
+            EXPECT("view", image_file.sample(2)[3] == 40);
+
+            const Core::size_type indices[] = { 2, 0 };
+
+            Core::Container<Core::Tensor> ibatch;
+            Core::Container<Core::Tensor> obatch;
+
+            image_file.gather(indices, 2, ibatch);
+            label_file.gather(indices, 2, obatch);
+
+            EXPECT("gather",
+                ibatch.size() == 2 && is_near(ibatch[0](0), 10. / 255.) && is_near(ibatch[1](1), 1.) &&
+                is_near(ibatch[1](2), 0.2)
+            );
+            EXPECT("one hot",
+                obatch[0](0) == 0.f && obatch[0](1) == 1.f && obatch[0](2) == 0.f && obatch[1](2) == 1.f
+            );
+
+            Normalizer normalizer(4);
+            normalizer.fit(image_file.dequantize(1.), 2);
+
+            EXPECT("normalizer", is_near(normalizer.mean()(0), 11. / 3.) && is_near(normalizer.mean()(3), 146. / 3.));
+
+            EXPECT("invalid", not trixy::data::IdxFile("auto_test_missing.idx").is_open());
+        }
+
+        // 3 samples are declared, only 2 are stored
+        std::ofstream("auto_test_images.idx", std::ios::binary).write(reinterpret_cast<const char*>(images), sizeof(images) - 4);
+
+        EXPECT("truncated", not trixy::data::IdxFile("auto_test_images.idx").is_open());
+
+        // 2^31 x 2^31 x 4 bytes wraps to zero in 64 bits
+        const unsigned char overflow[] = {
+            0x00, 0x00, 0x08, 0x03,  0x80, 0x00, 0x00, 0x00,  0x80, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x04,
+            1, 2, 3, 4
+        };
+
+        std::ofstream("auto_test_images.idx", std::ios::binary).write(reinterpret_cast<const char*>(overflow), sizeof(overflow));
+
+        EXPECT("overflow", not trixy::data::IdxFile("auto_test_images.idx").is_open());
+
+        std::remove("auto_test_images.idx");
+        std::remove("auto_test_labels.idx");
+    }
+}
+
+using Dataset = trixy::data::Dataset<Core>;
+using DataType = trixy::data::DataType;
+
+TEST(TestData, TestDataset)
+{
+    {
+        EXPECT("half",
+            trixy::detail::float_to_half(1.f) == 0x3C00 && trixy::detail::float_to_half(-2.f) == 0xC000 &&
+            trixy::detail::float_to_half(65504.f) == 0x7BFF && trixy::detail::float_to_half(1e6f) == 0x7C00 &&
+            trixy::detail::half_to_float(0x0001) == std::ldexp(1.f, -24) &&
+            trixy::detail::half_to_float(trixy::detail::float_to_half(0.1f)) == 0.0999755859375f
+        );
+        EXPECT("bfloat",
+            trixy::detail::float_to_bfloat(1.f) == 0x3F80 &&
+            trixy::detail::bfloat_to_float(trixy::detail::float_to_bfloat(3.140625f)) == 3.140625f
+        );
+    }
+    {
+        Core::Container<Core::Tensor> idata(40);
+        Core::Container<Core::Tensor> odata(40);
+
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            idata[i].resize(1, 1, 4);
+            for (Core::size_type j = 0; j < 4; ++j) idata[i](j) = static_cast<float>((i * 5 + j * 3) % 256) / 255.f;
+
+            odata[i].resize(1, 1, 2).fill(0.f);
+            odata[i](i % 2) = 1.f;
+        }
+
+        idata[1](0) = 1.f; // full range, so uint8 quantization is exact
+
+        Dataset compact_idata(idata, DataType::uint8);
+        Dataset compact_odata(odata, DataType::uint8);
+
+        Dataset half_idata(idata, DataType::float16);
+        Dataset bfloat_idata(idata, DataType::bfloat16);
+
+        EXPECT("size", compact_idata.size() == 40 && compact_idata.features() == 4 && compact_idata.bytes() == 160 &&
+                       half_idata.bytes() == 320);
+
+        Core::Tensor sample;
+        compact_idata.load(7, sample);
+
+        bool is_exact = true;
+        for (Core::size_type j = 0; j < 4; ++j) is_exact = is_exact && std::fabs(sample(j) - idata[7](j)) < 1e-6f;
+
+        half_idata.load(7, sample);
+        bool is_half = std::fabs(sample(1) - idata[7](1)) < 1e-3f;
+
+        bfloat_idata.load(7, sample);
+        bool is_bfloat = std::fabs(sample(1) - idata[7](1)) < 1e-2f;
+
+        EXPECT("dequantize", is_exact && is_half && is_bfloat && sample.shape().size == 4);
+
+        auto expected = make_net({ 4, 4, 2 }, 7);
+        auto result = make_net({ 4, 4, 2 }, 7);
+
+        trixy::train::Training<Net> expected_teach(*expected);
+        trixy::train::Training<Net> result_teach(*result);
+
+        expected_teach.loss(new MSE);
+        result_teach.loss(new MSE);
+
+        auto expected_optimizer = trixy::train::GradDescentOptimizer(*expected, 0.1f);
+        auto result_optimizer = trixy::train::GradDescentOptimizer(*result, 0.1f);
+
+        expected_teach.mini_batch(idata, odata, expected_optimizer, 3, 8);
+        result_teach.mini_batch(compact_idata, compact_odata, result_optimizer, 3, 8);
+
+        expected_teach.batch(idata, odata, expected_optimizer, 2);
+        result_teach.batch(compact_idata, compact_odata, result_optimizer, 2);
+
+        bool is_same = true;
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            const auto& x = expected->feedforward(idata[i]);
+            const auto& y = result->feedforward(idata[i]);
+
+            is_same = is_same && std::fabs(x(0) - y(0)) < 1e-5f && std::fabs(x(1) - y(1)) < 1e-5f;
+        }
+
+        EXPECT("training", is_same);
+    }
+}
+
+TEST(TestData, TestDataLoader)
+{
+    Core::Container<Core::Tensor> idata(30);
+    Core::Container<Core::Tensor> odata(30);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 3);
+        for (Core::size_type j = 0; j < 3; ++j) idata[i](j) = static_cast<float>((i * 7 + j * 2) % 11) / 11.f;
+        idata[i](2) = static_cast<float>(i); // index of sample
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](i % 2) = 1.f;
+    }
+
+    {
+        using Loader = trixy::data::DataLoader<Core, Core::Container<Core::Tensor>>;
+
+        Loader loader(idata, odata, 4, 3, 2);
+        loader.shuffle(11);
+
+        std::vector<Core::size_type> seen(idata.size(), 0);
+
+        bool is_pair = true;
+        bool is_ordered = true;
+
+        for (Core::size_type k = 0; k < 2 * loader.batches(); ++k)
+        {
+            const auto& batch = loader.acquire();
+
+            for (Core::size_type b = 0; b < batch.input.size(); ++b)
+            {
+                const auto i = static_cast<Core::size_type>(batch.input[b](2));
+
+                ++seen[i];
+                is_pair = is_pair && batch.target[b](i % 2) == 1.f;
+                is_ordered = is_ordered && i == (k % loader.batches()) * 4 + b;
+            }
+
+            loader.release();
+        }
+
+        // each epoch takes 28 different samples of 30
+        Core::size_type total = 0;
+        bool is_unique = true;
+        for (auto count : seen)
+        {
+            total += count;
+            is_unique = is_unique && count <= 2;
+        }
+
+        EXPECT("shuffle", loader.batches() == 7 && total == 2 * 7 * 4 && is_unique && is_pair && not is_ordered);
+    }
+    {
+        using Loader = trixy::data::DataLoader<Core, Core::Container<Core::Tensor>>;
+
+        Core::Container<Core::Tensor> empty;
+
+        Loader no_samples(empty, empty, 4, 2);
+        Loader no_batch_size(idata, odata, 0, 2);
+
+        // workers are never started, so destruction doesn't hang
+        EXPECT("empty", no_samples.batches() == 0 && no_batch_size.batches() == 0);
+    }
+    {
+        auto expected = make_net({ 3, 4, 2 }, 3);
+        auto result = make_net({ 3, 4, 2 }, 3);
+
+        trixy::train::Training<Net> expected_teach(*expected);
+        trixy::train::Training<Net> result_teach(*result);
+
+        expected_teach.loss(new MSE);
+        result_teach.loss(new MSE);
+
+        auto expected_optimizer = trixy::train::GradDescentOptimizer(*expected, 0.1f);
+        auto result_optimizer = trixy::train::GradDescentOptimizer(*result, 0.1f);
+
+        // without shuffle batches go in order, whatever the number of workers
+        trixy::data::DataLoader<Core, Core::Container<Core::Tensor>> loader(idata, odata, 5, 2);
+
+        expected_teach.mini_batch(idata, odata, expected_optimizer, 3, 5);
+        result_teach.mini_batch(loader, result_optimizer, 3);
+
+        bool is_same = true;
+        for (Core::size_type i = 0; i < idata.size(); ++i)
+        {
+            const auto& x = expected->feedforward(idata[i]);
+            const auto& y = result->feedforward(idata[i]);
+
+            is_same = is_same && std::fabs(x(0) - y(0)) < 1e-6f && std::fabs(x(1) - y(1)) < 1e-6f;
+        }
+
+        EXPECT("training", is_same);
+    }
+}
+
+TEST(TestTraining, TestShuffledMiniBatch)
+{
+    Core::Container<Core::Tensor> idata(24);
+    Core::Container<Core::Tensor> odata(24);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 3);
+        for (Core::size_type j = 0; j < 3; ++j) idata[i](j) = static_cast<float>((i * 5 + j * 3) % 13) / 13.f;
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](i % 2) = 1.f;
+    }
+
+    auto ordered = make_net({ 3, 4, 2 }, 5);
+    auto gathered = make_net({ 3, 4, 2 }, 5);
+    auto indexed = make_net({ 3, 4, 2 }, 5);
+
+    trixy::train::Training<Net> ordered_teach(*ordered);
+    trixy::train::Training<Net> gathered_teach(*gathered);
+    trixy::train::Training<Net> indexed_teach(*indexed);
+
+    ordered_teach.loss(new MSE);
+    gathered_teach.loss(new MSE);
+    indexed_teach.loss(new MSE);
+
+    auto ordered_optimizer = trixy::train::GradDescentOptimizer(*ordered, 0.1f);
+    auto gathered_optimizer = trixy::train::GradDescentOptimizer(*gathered, 0.1f);
+    auto indexed_optimizer = trixy::train::GradDescentOptimizer(*indexed, 0.1f);
+
+    std::mt19937_64 gathered_generator(17);
+    std::mt19937_64 indexed_generator(17);
+
+    ordered_teach.mini_batch(idata, odata, ordered_optimizer, 4, 6);
+    gathered_teach.mini_batch(idata, odata, gathered_optimizer, 4, 6, gathered_generator);
+    indexed_teach.mini_batch(idata, odata, indexed_optimizer, 4, 6, indexed_generator, false);
+
+    bool is_same = true;
+    bool is_shuffled = false;
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        const auto& x = gathered->feedforward(idata[i]);
+        const auto& y = indexed->feedforward(idata[i]);
+        const auto& z = ordered->feedforward(idata[i]);
+
+        is_same = is_same && std::fabs(x(0) - y(0)) < 1e-6f && std::fabs(x(1) - y(1)) < 1e-6f;
+        is_shuffled = is_shuffled || std::fabs(x(0) - z(0)) > 1e-6f;
+    }
+
+    EXPECT("gather", is_same && is_shuffled);
+
+    {
+        std::vector<std::size_t> order(100);
+        for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+        std::mt19937_64 generator(3);
+        trixy::data::shuffle(order.data(), order.data() + order.size(), generator);
+
+        std::vector<std::size_t> sorted(order);
+        std::sort(sorted.begin(), sorted.end());
+
+        bool is_permutation = true;
+        for (std::size_t i = 0; i < sorted.size(); ++i) is_permutation = is_permutation && sorted[i] == i;
+
+        EXPECT("permutation", is_permutation && order != sorted);
+    }
+    {
+        // values of the 32 bit generator are concatenated
+        std::mt19937 narrow(5);
+        std::mt19937 reference(5);
+
+        const std::uint64_t high = reference();
+        const std::uint64_t low = reference();
+
+        EXPECT("narrow generator", trixy::data::draw(narrow) == (high << 32 | low));
+
+        std::vector<std::size_t> order(100);
+        for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+        trixy::data::shuffle(order.data(), order.data() + order.size(), narrow);
+
+        std::vector<std::size_t> sorted(order);
+        std::sort(sorted.begin(), sorted.end());
+
+        bool is_permutation = true;
+        for (std::size_t i = 0; i < sorted.size(); ++i) is_permutation = is_permutation && sorted[i] == i;
+
+        EXPECT("narrow permutation", is_permutation && order != sorted);
+    }
+}
+
+// Two steps of update_all() over all parameters against update() of each one with pre-scaled gradients
+template <class Optimizer>
+bool is_same_update_all(Optimizer expected_optimizer, Optimizer result_optimizer, Core::size_type count)
+{
+    using Parameter = typename Optimizer::Parameter;
+
+    const Core::size_type sizes[] = { 10000, 3 };
+    const float alpha = 0.5f;
+
+    std::vector<Core::Tensor> expected, result, grad, scaled;
+    for (Core::size_type p = 0; p < count; ++p)
+    {
+        expected.emplace_back(1, 1, sizes[p]);
+        result.emplace_back(1, 1, sizes[p]);
+        grad.emplace_back(1, 1, sizes[p]);
+        scaled.emplace_back(1, 1, sizes[p]);
+
+        for (Core::size_type i = 0; i < sizes[p]; ++i)
+        {
+            expected[p](i) = result[p](i) = static_cast<float>(i % 17) / 17.f - 0.5f;
+            grad[p](i) = static_cast<float>((i * 7 + p) % 11) / 11.f - 0.3f;
+        }
+    }
+
+    std::vector<Parameter> parameters;
+    for (Core::size_type p = 0; p < count; ++p)
+        parameters.push_back({ result[p].data(), grad[p].data(), result[p].size() });
+
+    for (int step = 0; step < 2; ++step)
+    {
+        // update() may spoil gradient
+        for (Core::size_type p = 0; p < count; ++p)
+        {
+            for (Core::size_type i = 0; i < sizes[p]; ++i) scaled[p](i) = alpha * grad[p](i);
+            expected_optimizer.update(expected[p], scaled[p]);
+        }
+
+        result_optimizer.update_all(parameters.data(), parameters.size(), alpha);
+    }
+
+    bool is_same = true;
+    for (Core::size_type p = 0; p < count; ++p)
+        for (Core::size_type i = 0; i < sizes[p]; ++i)
+            is_same = is_same && std::fabs(expected[p](i) - result[p](i)) < 1e-5f;
+
+    return is_same;
+}
+
+TEST(TestOptimizer, TestUpdateAll)
+{
+    Net net;
+
+    EXPECT("grad descent", is_same_update_all(trixy::train::GradDescentOptimizer(net, 0.1f),
+                                              trixy::train::GradDescentOptimizer(net, 0.1f), 2));
+    EXPECT("sto grad descent", is_same_update_all(trixy::train::StoGradDescentOptimizer(net, 0.1f, 0.01f),
+                                                  trixy::train::StoGradDescentOptimizer(net, 0.1f, 0.01f), 2));
+    EXPECT("momentum", is_same_update_all(trixy::train::MomentumOptimizer(net, 0.1f),
+                                          trixy::train::MomentumOptimizer(net, 0.1f), 2));
+    EXPECT("nestorov", is_same_update_all(trixy::train::NestorovOptimizer(net, 0.1f),
+                                          trixy::train::NestorovOptimizer(net, 0.1f), 2));
+    EXPECT("ada grad", is_same_update_all(trixy::train::AdaGradOptimizer(net, 0.1f),
+                                          trixy::train::AdaGradOptimizer(net, 0.1f), 2));
+    EXPECT("rms prop", is_same_update_all(trixy::train::RMSPropOptimizer(net, 0.1f),
+                                          trixy::train::RMSPropOptimizer(net, 0.1f), 2));
+    // update() of adam counts a step for each parameter
+    EXPECT("adam", is_same_update_all(trixy::train::AdamOptimizer(net, 0.01f),
+                                      trixy::train::AdamOptimizer(net, 0.01f), 1));
+
+    {
+        using Parameter = trixy::train::IOptimizer<Net>::Parameter;
+
+        Core::Tensor param(1, 1, 2);
+        Core::Tensor grad(1, 1, 2);
+
+        grad(0) = 3.f;
+        grad(1) = 4.f;
+
+        Parameter parameter = { param.data(), grad.data(), param.size() };
+
+        auto optimizer = trixy::train::GradDescentOptimizer(net, 1.f);
+        optimizer.clip(20.f);
+
+        // norm of the scaled gradient is 10
+        param.fill(0.f);
+        optimizer.update_all(&parameter, 1, 2.f);
+
+        EXPECT("without clip", is_near(param(0), -6.) && is_near(param(1), -8.));
+
+        optimizer.clip(1.f);
+
+        param.fill(0.f);
+        optimizer.update_all(&parameter, 1, 2.f);
+
+        EXPECT("clip", is_near(param(0), -0.6) && is_near(param(1), -0.8) && grad(0) == 3.f);
+
+        optimizer.clip(0.f);
+        optimizer.learning_rate(0.1f);
+        optimizer.weight_decay(0.5f);
+
+        grad.fill(0.f);
+        param.fill(2.f);
+        optimizer.update_all(&parameter, 1, 1.f);
+
+        EXPECT("weight decay", is_near(param(0), 1.9) && is_near(param(1), 1.9));
+    }
+    {
+        // update() of the layer clips by the norm of this layer only
+        FullyConnected first(2, 2);
+        FullyConnected second(2, 2);
+
+        Core::Tensor input(1, 1, 2);
+        input.fill(1.f);
+
+        Core::Tensor idelta(1, 1, 2);
+        idelta(0) = 3.f;
+        idelta(1) = 4.f;
+
+        first.forward(input);
+        first.backward(input, idelta);
+
+        idelta.fill(100.f);
+
+        second.forward(input);
+        second.backward(input, idelta);
+
+        auto optimizer = trixy::train::GradDescentOptimizer(net, 1.f);
+        optimizer.clip(1.f);
+
+        first.update(optimizer, 1.f);
+        second.update(optimizer, 1.f);
+
+        auto step = [](const FullyConnected& layer)
+        {
+            double sum = 0.;
+            for (Core::size_type i = 0; i < layer.B_.size(); ++i) sum += layer.B_(i) * layer.B_(i);
+            for (Core::size_type i = 0; i < layer.W_.size(); ++i) sum += layer.W_(i) * layer.W_(i);
+
+            return std::sqrt(sum);
+        };
+
+        EXPECT("layer clip", is_near(step(first), 1.) && is_near(step(second), 1.));
+    }
+}
+
+TEST(TestOptimizer, TestLayerWise)
+{
+    Net net;
+
+    using Parameter = trixy::train::IOptimizer<Net>::Parameter;
+
+    Core::Tensor param(1, 1, 2);
+    Core::Tensor grad(1, 1, 2);
+
+    Parameter parameter = { param.data(), grad.data(), param.size() };
+    {
+        param(0) = 3.f; param(1) = 4.f;
+        grad(0) = 6.f;  grad(1) = 8.f;
+
+        // local rate = 1 * 0.5 * 5 / 10
+        auto optimizer = trixy::train::LARSOptimizer(net, 1.f, 0.f, 0.5f);
+        optimizer.update_all(&parameter, 1, 1.f);
+
+        EXPECT("lars", is_near(param(0), 1.5) && is_near(param(1), 2.));
+    }
+    {
+        param(0) = 3.f; param(1) = 4.f;
+        grad(0) = 1.f;  grad(1) = -1.f;
+
+        // first adam step is sign(g), trust ratio = 5 / sqrt(2)
+        auto optimizer = trixy::train::LAMBOptimizer(net, 0.1f);
+        optimizer.update_all(&parameter, 1, 1.f);
+
+        EXPECT("lamb", std::fabs(param(0) - 2.646447f) < 1e-4f && std::fabs(param(1) - 4.353553f) < 1e-4f);
+    }
+
+    // large batch training: 4096 points of two classes divided by the line, 4 updates per epoch
+    Core::Container<Core::Tensor> idata(4096);
+    Core::Container<Core::Tensor> odata(4096);
+
+    Uniform random(7);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 2);
+        idata[i](0) = random();
+        idata[i](1) = random();
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](idata[i](0) + 0.5f * idata[i](1) > 0.f ? 1 : 0) = 1.f;
+    }
+
+    auto lamb = make_net({ 2, 16, 2 }, 7);
+    auto lars = make_net({ 2, 16, 2 }, 7);
+
+    trixy::train::Training<Net> lamb_teach(*lamb);
+    trixy::train::Training<Net> lars_teach(*lars);
+
+    lamb_teach.loss(new SoftmaxCrossEntropy);
+    lars_teach.loss(new SoftmaxCrossEntropy);
+
+    auto lamb_optimizer = trixy::train::LAMBOptimizer(*lamb, 0.05f);
+    auto lars_optimizer = trixy::train::LARSOptimizer(*lars, 1.f, 0.9f, 0.02f);
+
+    lamb_teach.mini_batch(idata, odata, lamb_optimizer, 50, 1024);
+    lars_teach.mini_batch(idata, odata, lars_optimizer, 50, 1024);
+
+    trixy::Checker<Net> lamb_check(*lamb);
+    trixy::Checker<Net> lars_check(*lars);
+
+    const double lamb_accuracy = lamb_check.accuracy(idata, odata);
+    const double lars_accuracy = lars_check.accuracy(idata, odata);
+
+    EXPECT("lamb large batch", lamb_accuracy > 0.95);
+    EXPECT("lars large batch", lars_accuracy > 0.95);
+}
+
+TEST(TestOptimizer, TestSerialization)
+{
+    Core::Container<Core::Tensor> idata(12);
+    Core::Container<Core::Tensor> odata(12);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 3);
+        for (Core::size_type j = 0; j < 3; ++j) idata[i](j) = static_cast<float>((i * 3 + j * 5) % 11) / 11.f;
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](i % 2) = 1.f;
+    }
+
+    // trained and resumed nets have equal weights, but different tensor addresses
+    auto trained = make_net({ 3, 5, 2 }, 11);
+    auto resumed = make_net({ 3, 5, 2 }, 11);
+    auto restarted = make_net({ 3, 5, 2 }, 11);
+
+    trixy::train::Training<Net> trained_teach(*trained);
+    trixy::train::Training<Net> resumed_teach(*resumed);
+    trixy::train::Training<Net> restarted_teach(*restarted);
+
+    trained_teach.loss(new MSE);
+    resumed_teach.loss(new MSE);
+    restarted_teach.loss(new MSE);
+
+    auto trained_optimizer = trixy::train::AdamOptimizer(*trained, 0.01f);
+    trained_optimizer.weight_decay(0.01f);
+
+    auto warmup_optimizer = trixy::train::AdamOptimizer(*resumed, 0.01f);
+    warmup_optimizer.weight_decay(0.01f);
+
+    auto restarted_optimizer = trixy::train::AdamOptimizer(*restarted, 0.01f);
+    restarted_optimizer.weight_decay(0.01f);
+
+    trained_teach.mini_batch(idata, odata, trained_optimizer, 3, 4);
+    resumed_teach.mini_batch(idata, odata, warmup_optimizer, 3, 4);
+    restarted_teach.mini_batch(idata, odata, restarted_optimizer, 3, 4);
+
+    std::vector<unsigned char> storage;
+    {
+        auto archive = sf::oarchive(storage);
+        archive & trained_optimizer;
+    }
+
+    auto resumed_optimizer = trixy::train::AdamOptimizer(*resumed, 0.1f);
+    {
+        auto archive = sf::iarchive(storage);
+        archive & resumed_optimizer;
+    }
+
+    restarted_optimizer.reset();
+
+    trained_teach.mini_batch(idata, odata, trained_optimizer, 2, 4);
+    resumed_teach.mini_batch(idata, odata, resumed_optimizer, 2, 4);
+    restarted_teach.mini_batch(idata, odata, restarted_optimizer, 2, 4);
+
+    bool is_same = true;
+    bool is_restarted = false;
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        const auto& x = trained->feedforward(idata[i]);
+        const auto& y = resumed->feedforward(idata[i]);
+        const auto& z = restarted->feedforward(idata[i]);
+
+        is_same = is_same && std::fabs(x(0) - y(0)) < 1e-6f && std::fabs(x(1) - y(1)) < 1e-6f;
+        is_restarted = is_restarted || std::fabs(x(0) - z(0)) > 1e-4f;
+    }
+
+    EXPECT("resume", is_same && is_near(resumed_optimizer.learning_rate(), 0.01)
+                     && is_near(resumed_optimizer.weight_decay(), 0.01));
+    EXPECT("restart", is_restarted);
+}
+
+TEST(TestRandom, TestGenerator)
+{
+    {
+        // state is expanded from the seed by splitmix64
+        trixy::utility::Xoshiro256 generator(0);
+
+        EXPECT("xoshiro", generator() == 0x53175D61490B23DFull && generator() == 0x61DA6F3DC380D507ull);
+    }
+    {
+        trixy::utility::Philox generator(0, 0);
+
+        std::uint64_t out[2];
+        generator.block(0, out);
+
+        EXPECT("philox", out[0] == 0xE169C58D6627E8D5ull && out[1] == 0x9B00DBD8BC57AC4Cull);
+    }
+    {
+        trixy::utility::Xoshiro256 generator(42);
+        trixy::utility::Xoshiro256 stream = generator.split();
+
+        trixy::utility::Xoshiro256 jumped(42);
+        jumped.jump();
+
+        bool is_split = generator() == jumped() && stream() != generator();
+
+        std::vector<double> values(1000);
+        generator.fill(values.data(), values.data() + values.size(), -1., 1.);
+
+        double mean = 0.;
+        bool is_range = true;
+        for (auto value : values)
+        {
+            mean += value;
+            is_range = is_range && value >= -1. && value < 1.;
+        }
+
+        EXPECT("split", is_split && is_range && std::fabs(mean / values.size()) < 0.1);
+    }
+    {
+        trixy::utility::Philox generator(7);
+
+        std::vector<float> values(10000);
+        generator.fill(values.data(), values.data() + values.size());
+
+        // the same values are generated by blocks one by one
+        trixy::utility::Philox sequence(7);
+
+        bool is_same = true;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            is_same = is_same && values[i] == trixy::utility::detail::uniform<float>(sequence());
+
+        trixy::utility::Philox other = generator.split(1);
+
+        EXPECT("fill", is_same && generator() == sequence() && other() != trixy::utility::Philox(7)());
+    }
+    {
+        trixy::utility::RandomIntegral<long long> random(5);
+
+        bool is_range = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const long long value = random(-3, 3);
+            is_range = is_range && value >= -3 && value <= 3 && random() >= 0;
+        }
+
+        float p[] = { 0.f, 1.f, 0.f };
+
+        EXPECT("random", is_range && trixy::lique::multinomial(p, p + 3) == 1);
+    }
+}
+
+TEST(TestNeuro, TestInitialization)
+{
+    using InitializationId = trixy::functional::InitializationId;
+
+    auto stats = [](const float* first, const float* last, double& mean, double& std, double& max)
+    {
+        const double size = static_cast<double>(last - first);
+
+        mean = 0.; std = 0.; max = 0.;
+        for (auto it = first; it != last; ++it) mean += *it;
+        mean /= size;
+
+        for (auto it = first; it != last; ++it)
+        {
+            std += (*it - mean) * (*it - mean);
+            if (std::fabs(*it) > max) max = std::fabs(*it);
+        }
+        std = std::sqrt(std / size);
+    };
+
+    Net net;
+    net.add(new FullyConnected(400, 300, new ReLU))
+       .add(new FullyConnected(300, 10));
+
+    net.init(InitializationId::he_uniform, 42);
+
+    auto& first = static_cast<FullyConnected&>(net.layer(0));
+    auto& second = static_cast<FullyConnected&>(net.layer(1));
+
+    double mean, std, max;
+    stats(first.W_.data(), first.W_.data() + first.W_.size(), mean, std, max);
+
+    // U(-a, a) has std = a / sqrt(3) = sqrt(2 / fan_in)
+    const double limit = std::sqrt(6. / 400.);
+    EXPECT("he uniform", std::fabs(mean) < 0.005 && std::fabs(std - limit / std::sqrt(3.)) < 0.002 &&
+                         max <= limit && first.B_(0) == 0.f);
+
+    net.init(InitializationId::xavier_normal, 42);
+
+    stats(second.W_.data(), second.W_.data() + second.W_.size(), mean, std, max);
+    EXPECT("xavier normal", std::fabs(mean) < 0.01 && std::fabs(std - std::sqrt(2. / 310.)) < 0.01);
+
+    Net other;
+    other.add(new FullyConnected(400, 300, new ReLU))
+         .add(new FullyConnected(300, 10));
+
+    other.init(InitializationId::xavier_normal, 42);
+
+    auto& other_first = static_cast<FullyConnected&>(other.layer(0));
+
+    bool is_same = true;
+    for (Core::size_type i = 0; i < first.W_.size(); ++i)
+        is_same = is_same && first.W_.data()[i] == other_first.W_.data()[i];
+
+    // layers take independent streams
+    EXPECT("stream", is_same && first.W_.data()[0] != second.W_.data()[0]);
+
+    {
+        auto layer = new Convolutional(Input(2, 6, 6), Filter(4, 3, 3));
+
+        Net cnn;
+        cnn.add(layer);
+        cnn.init(InitializationId::lecun_uniform, 1);
+
+        bool is_range = true;
+        for (const auto& W : layer->Ws_)
+            for (Core::size_type i = 0; i < W.size(); ++i)
+                is_range = is_range && std::fabs(W.data()[i]) <= std::sqrt(3. / 18.) && W.data()[i] != 0.f;
+
+        EXPECT("convolutional", is_range);
+    }
+}
+
+template <class Compute>
+using MixedNet = trixy::TrixyNet<trixy::TypeSet<float, Compute>>;
+
+template <class Compute>
+void mixed_precision_test(const char* name, float tolerance)
+{
+    using Mixed = MixedNet<Compute>;
+    using MixedFullyConnected = trixy::layer::FullyConnected<Mixed>;
+    using Codec = trixy::lique::Reduced<Compute>;
+
+    // odd sizes take both vectorized and tail parts of the products
+    auto make = [](Mixed& net)
+    {
+        net.add(new MixedFullyConnected(37, 21, new ReLU))
+           .add(new MixedFullyConnected(21, 2));
+
+        net.init(trixy::functional::InitializationId::he_uniform, 3);
+    };
+
+    Net full;
+    full.add(new FullyConnected(37, 21, new ReLU))
+        .add(new FullyConnected(21, 2));
+
+    full.init(trixy::functional::InitializationId::he_uniform, 3);
+
+    Mixed mixed;
+    make(mixed);
+
+    Uniform random(11);
+
+    Core::Container<Core::Tensor> idata(512);
+    Core::Container<Core::Tensor> odata(512);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 37);
+        for (Core::size_type j = 0; j < 37; ++j) idata[i](j) = random();
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](idata[i](0) - idata[i](36) > 0.f ? 1 : 0) = 1.f;
+    }
+
+    bool is_close = true;
+    for (Core::size_type i = 0; i < 16; ++i)
+    {
+        const auto& lhs = full.feedforward(idata[i]);
+        const auto& rhs = mixed.feedforward(idata[i]);
+
+        for (Core::size_type j = 0; j < lhs.size(); ++j)
+            is_close = is_close && std::fabs(lhs(j) - rhs(j)) < tolerance * (1.f + std::fabs(lhs(j)));
+    }
+
+    EXPECT(name, is_close);
+
+    trixy::train::Training<Mixed> teach(mixed);
+    teach.loss(new SoftmaxCrossEntropy);
+
+    auto optimizer = trixy::train::AdamOptimizer(mixed, 0.01f);
+    teach.mini_batch(idata, odata, optimizer, 30, 32);
+
+    trixy::Checker<Mixed> check(mixed);
+    EXPECT(name, check.accuracy(idata, odata) > 0.95);
+
+    // compute copy follows the float master weights after each update
+    auto& layer = static_cast<MixedFullyConnected&>(mixed.layer(0));
+
+    bool is_synchronized = layer.computeW_.size() == layer.W_.size();
+    for (Core::size_type i = 0; i < layer.W_.size() && is_synchronized; ++i)
+        is_synchronized = layer.computeW_.data()[i] == Codec::encode(layer.W_.data()[i]);
+
+    EXPECT(name, is_synchronized);
+}
+
+TEST(TestNeuro, TestMixedPrecision)
+{
+    mixed_precision_test<trixy::ComputeType::BFloat16>("bfloat16", 2e-2f);
+    mixed_precision_test<trixy::ComputeType::Half>("half", 2e-3f);
+}
+
+using QFullyConnected = trixy::layer::QFullyConnected<Net>;
+using QConvolutional = trixy::layer::QConvolutional<Net>;
+
+TEST(TestNeuro, TestQuantization)
+{
+    // images of two classes: brighter left or right half
+    Core::Container<Core::Tensor> idata(512);
+    Core::Container<Core::Tensor> odata(512);
+
+    Uniform random(5, 0.f, 1.f);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        const Core::size_type label = i % 2;
+
+        idata[i].resize(Input(1, 6, 6));
+        for (Core::size_type y = 0; y < 6; ++y)
+            for (Core::size_type x = 0; x < 6; ++x)
+                idata[i](0, y, x) = random() + ((x < 3) == (label == 0) ? 0.4f : 0.f);
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](label) = 1.f;
+    }
+
+    Net net;
+    net.add(new FullyConnected(36, 16, new ReLU))
+       .add(new FullyConnected(16, 2));
+
+    net.init(trixy::functional::InitializationId::he_uniform, 9);
+
+    trixy::train::Training<Net> teach(net);
+    teach.loss(new SoftmaxCrossEntropy);
+
+    auto optimizer = trixy::train::AdamOptimizer(net, 0.005f);
+    teach.mini_batch(idata, odata, optimizer, 10, 16);
+
+    trixy::Checker<Net> check(net);
+    const double accuracy = check.accuracy(idata, odata);
+
+    Core::Container<Core::Tensor> expected;
+    for (Core::size_type i = 0; i < 32; ++i) expected.emplace_back(net.feedforward(idata[i]));
+
+    trixy::Quantizer<Net> quantizer(net);
+    quantizer.calibrate(idata);
+
+    EXPECT("replace", quantizer.quantize() == 2 && dynamic_cast<QFullyConnected*>(&net.layer(0)) != nullptr);
+
+    bool is_close = true;
+    for (Core::size_type i = 0; i < expected.size(); ++i)
+    {
+        const auto& y = net.feedforward(idata[i]);
+        for (Core::size_type j = 0; j < y.size(); ++j)
+            is_close = is_close && std::fabs(y(j) - expected[i](j)) < 0.05f * (1.f + std::fabs(expected[i](j)));
+    }
+
+    const double quantized_accuracy = check.accuracy(idata, odata);
+
+    EXPECT("value", is_close);
+    EXPECT("accuracy", accuracy > 0.95 && std::fabs(accuracy - quantized_accuracy) < 0.02);
+
+    {
+        Net cnn;
+        cnn.add(new XConvolutional(Input(3, 5, 5), Filter(2, 3, 3), Padding(1), Stride(2)));
+        cnn.init([&random] { return random() - 0.5f; });
+
+        Core::Container<Core::Tensor> images(16);
+        for (auto& image : images) image.resize(Input(3, 5, 5)).fill(random);
+
+        Core::Container<Core::Tensor> values;
+        for (const auto& image : images) values.emplace_back(cnn.feedforward(image));
+
+        trixy::Quantizer<Net> cnn_quantizer(cnn);
+        cnn_quantizer.calibrate(images);
+
+        EXPECT("convolutional", cnn_quantizer.quantize() == 1 && dynamic_cast<QConvolutional*>(&cnn.layer(0)) != nullptr);
+
+        bool is_near_value = true;
+        for (Core::size_type i = 0; i < images.size(); ++i)
+        {
+            const auto& y = cnn.feedforward(images[i]);
+            for (Core::size_type j = 0; j < y.size(); ++j)
+                is_near_value = is_near_value && std::fabs(y(j) - values[i](j)) < 0.03f;
+        }
+
+        EXPECT("convolutional value", is_near_value);
+    }
+
+    // quantized layer has own format
+    auto& layer = static_cast<QFullyConnected&>(net.layer(0));
+
+    std::vector<unsigned char> storage;
+    {
+        auto archive = sf::oarchive(storage);
+        archive & layer;
+    }
+
+    QFullyConnected loaded;
+    {
+        auto archive = sf::iarchive(storage);
+        archive & loaded;
+    }
+
+    loaded.connect(new ReLU);
+
+    Core::Tensor output(loaded.osize());
+
+    layer.forward(idata[0]);
+    loaded.forward(idata[0], output);
+
+    bool is_same = loaded.input_scale() == layer.input_scale();
+    for (Core::size_type j = 0; j < output.size(); ++j) is_same = is_same && output(j) == layer.value()(j);
+
+    EXPECT("serialization", is_same);
+}
+
+using SFullyConnected = trixy::layer::SFullyConnected<Net>;
+
+TEST(TestNeuro, TestPruning)
+{
+    Core::Container<Core::Tensor> idata(512);
+    Core::Container<Core::Tensor> odata(512);
+
+    Uniform random(7, 0.f, 1.f);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        const Core::size_type label = i % 2;
+
+        idata[i].resize(1, 1, 36);
+        for (Core::size_type j = 0; j < 36; ++j)
+            idata[i](j) = random() + ((j < 18) == (label == 0) ? 0.4f : 0.f);
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](label) = 1.f;
+    }
+
+    Net net;
+    net.add(new FullyConnected(36, 30, new ReLU))
+       .add(new FullyConnected(30, 2));
+
+    net.init(trixy::functional::InitializationId::he_uniform, 4);
+
+    trixy::train::Training<Net> teach(net);
+    teach.loss(new SoftmaxCrossEntropy);
+
+    auto optimizer = trixy::train::AdamOptimizer(net, 0.005f);
+    teach.mini_batch(idata, odata, optimizer, 10, 16);
+
+    auto& first = static_cast<FullyConnected&>(net.layer(0));
+
+    auto zeros = [](const FullyConnected& layer)
+    {
+        Core::size_type count = 0;
+        for (Core::size_type i = 0; i < layer.W_.size(); ++i) count += layer.W_.data()[i] == 0.f;
+
+        return count;
+    };
+
+    trixy::Pruner<Net> pruner(net);
+    pruner.prune(0.75);
+
+    EXPECT("sparsity", zeros(first) >= 810 && zeros(static_cast<FullyConnected&>(net.layer(1))) >= 45);
+
+    // zeros fill whole blocks of 4 outputs of one input, which the sparse form doesn't store
+    bool is_blocked = true;
+    for (Core::size_type j = 0; j < 36; ++j)
+    {
+        for (Core::size_type b = 0; b < 30; b += 4)
+        {
+            const Core::size_type length = std::min<Core::size_type>(4, 30 - b);
+
+            Core::size_type count = 0;
+            for (Core::size_type k = 0; k < length; ++k) count += first.W_(j, b + k) == 0.f;
+
+            is_blocked = is_blocked && (count == 0 || count == length);
+        }
+    }
+
+    EXPECT("blocks", is_blocked);
+
+    // fine-tuning keeps the pruned weights
+    teach.mini_batch(idata, odata, optimizer, 5, 16);
+
+    trixy::Checker<Net> check(net);
+    EXPECT("fine-tuning", zeros(first) >= 810 && check.accuracy(idata, odata) > 0.95);
+
+    Core::Container<Core::Tensor> expected;
+    for (Core::size_type i = 0; i < 32; ++i) expected.emplace_back(net.feedforward(idata[i]));
+
+    EXPECT("replace", pruner.sparsify() == 2 && dynamic_cast<SFullyConnected*>(&net.layer(0)) != nullptr);
+
+    bool is_close = true;
+    for (Core::size_type i = 0; i < expected.size(); ++i)
+    {
+        const auto& y = net.feedforward(idata[i]);
+        for (Core::size_type j = 0; j < y.size(); ++j)
+            is_close = is_close && std::fabs(y(j) - expected[i](j)) < 1e-5f * (1.f + std::fabs(expected[i](j)));
+    }
+
+    auto& layer = static_cast<SFullyConnected&>(net.layer(0));
+
+    EXPECT("value", is_close);
+    EXPECT("storage", layer.sparsity() > 0.7);
+
+    std::vector<unsigned char> storage;
+    {
+        auto archive = sf::oarchive(storage);
+        archive & layer;
+    }
+
+    SFullyConnected loaded;
+    {
+        auto archive = sf::iarchive(storage);
+        archive & loaded;
+    }
+
+    loaded.connect(new ReLU);
+
+    Core::Tensor output(loaded.osize());
+
+    layer.forward(idata[0]);
+    loaded.forward(idata[0], output);
+
+    bool is_same = loaded.sparsity() == layer.sparsity();
+    for (Core::size_type j = 0; j < output.size(); ++j) is_same = is_same && output(j) == layer.value()(j);
+
+    EXPECT("serialization", is_same);
+}
+
+TEST(TestNeuro, TestArena)
+{
+    Uniform random(13);
+
+    Net net;
+    net.add(new FullyConnected(36, 64, new ReLU))
+       .add(new FullyConnected(64, 8, new ReLU))
+       .add(new FullyConnected(8, 64, new ReLU))
+       .add(new FullyConnected(64, 2));
+
+    net.init(trixy::functional::InitializationId::he_uniform, 2);
+
+    auto arena = net.arena();
+
+    // output slots take the widest layers of own parity
+    EXPECT("plan", arena.buffer[0].size() == 64 && arena.buffer[1].size() == 8);
+
+    bool is_same = true;
+    for (Core::size_type i = 0; i < 8; ++i)
+    {
+        Core::Tensor sample(1, 1, 36);
+        sample.fill(random);
+
+        const auto& planned = net.feedforward(sample, arena);
+        const auto& expected = net.feedforward(sample);
+
+        is_same = is_same && planned.shape().size == 2;
+        for (Core::size_type j = 0; j < planned.size(); ++j) is_same = is_same && planned(j) == expected(j);
+    }
+
+    EXPECT("value", is_same);
+
+    Net cnn;
+    cnn.add(new XConvolutional(Input(2, 6, 6), Filter(3, 3, 3), Padding(1)))
+       .add(new XMaxPooling(Input(3, 6, 6), Stride(2)));
+
+    cnn.init([&random] { return random(); });
+
+    Core::Tensor image(Input(2, 6, 6));
+    image.fill(random);
+
+    auto workspace = cnn.workspace();
+    auto cnn_arena = cnn.arena();
+
+    const auto& expected = cnn.feedforward(image, workspace);
+    const auto& planned = cnn.feedforward(image, cnn_arena);
+
+    bool is_same_cnn = planned.shape().depth == 3 && planned.shape().height == 3 && planned.size() == expected.size();
+    for (Core::size_type j = 0; j < expected.size() && is_same_cnn; ++j) is_same_cnn = planned(j) == expected(j);
+
+    // inference layers don't keep own outputs until they are used
+    EXPECT("convolutional", is_same_cnn && cnn.layer(0).value().size() == 0);
+}
+
+TEST(TestTraining, TestRecompute)
+{
+    Uniform random(21);
+
+    Core::Container<Core::Tensor> idata(128);
+    Core::Container<Core::Tensor> odata(128);
+
+    for (Core::size_type i = 0; i < idata.size(); ++i)
+    {
+        idata[i].resize(1, 1, 16).fill(random);
+
+        odata[i].resize(1, 1, 2).fill(0.f);
+        odata[i](idata[i](0) + idata[i](15) > 0.f ? 1 : 0) = 1.f;
+    }
+
+    auto make = [](Net& net)
+    {
+        net.add(new FullyConnected(16, 24, new ReLU))
+           .add(new FullyConnected(24, 24, new ReLU))
+           .add(new FullyConnected(24, 24, new ReLU))
+           .add(new FullyConnected(24, 24, new ReLU))
+           .add(new FullyConnected(24, 2));
+
+        net.init(trixy::functional::InitializationId::he_uniform, 8);
+    };
+
+    Net full;
+    make(full);
+
+    Net checkpointed;
+    make(checkpointed);
+
+    trixy::train::Training<Net> full_teach(full);
+    full_teach.loss(new SoftmaxCrossEntropy);
+
+    trixy::train::Training<Net> teach(checkpointed);
+    teach.loss(new SoftmaxCrossEntropy);
+    teach.recompute(2);
+
+    auto full_optimizer = trixy::train::AdamOptimizer(full, 0.01f);
+    auto optimizer = trixy::train::AdamOptimizer(checkpointed, 0.01f);
+
+    full_teach.batch(idata, odata, full_optimizer, 5);
+    teach.batch(idata, odata, optimizer, 5);
+
+    // recomputed activations are the same, so are the gradients
+    bool is_same = true;
+    for (Core::size_type l = 0; l < full.size(); ++l)
+    {
+        const auto& lhs = static_cast<FullyConnected&>(full.layer(l));
+        const auto& rhs = static_cast<FullyConnected&>(checkpointed.layer(l));
+
+        for (Core::size_type i = 0; i < lhs.W_.size(); ++i) is_same = is_same && lhs.W_.data()[i] == rhs.W_.data()[i];
+    }
+
+    EXPECT("gradient", is_same);
+
+    // only the last segment keeps activations
+    EXPECT("release", checkpointed.layer(0).value().size() == 0 && checkpointed.layer(3).value().size() == 0 &&
+                      checkpointed.layer(4).value().size() == 2);
+
+    teach.recompute(0);
+    teach.batch(idata, odata, optimizer, 1);
+
+    EXPECT("disable", checkpointed.layer(0).value().size() == 24);
+
+    // conv and pooling layers of different sizes take turns in the planned buffers
+    auto make_cnn = [](Net& net)
+    {
+        net.add(new Convolutional(Input(1, 6, 6), Filter(2, 3, 3)))
+           .add(new MaxPooling(Input(2, 4, 4), Stride(2), new ReLU))
+           .add(new FullyConnected(8, 2));
+
+        net.init(trixy::functional::InitializationId::he_uniform, 9);
+    };
+
+    Core::Container<Core::Tensor> images(32);
+    Core::Container<Core::Tensor> labels(32);
+
+    for (Core::size_type i = 0; i < images.size(); ++i)
+    {
+        images[i].resize(1, 6, 6).fill(random);
+        labels[i] = odata[i];
+    }
+
+    Net full_cnn;
+    make_cnn(full_cnn);
+
+    Net checkpointed_cnn;
+    make_cnn(checkpointed_cnn);
+
+    trixy::train::Training<Net> full_cnn_teach(full_cnn);
+    full_cnn_teach.loss(new SoftmaxCrossEntropy);
+
+    trixy::train::Training<Net> cnn_teach(checkpointed_cnn);
+    cnn_teach.loss(new SoftmaxCrossEntropy);
+    cnn_teach.recompute(1);
+
+    auto full_cnn_optimizer = trixy::train::AdamOptimizer(full_cnn, 0.01f);
+    auto cnn_optimizer = trixy::train::AdamOptimizer(checkpointed_cnn, 0.01f);
+
+    full_cnn_teach.mini_batch(images, labels, full_cnn_optimizer, 3, 8);
+    cnn_teach.mini_batch(images, labels, cnn_optimizer, 3, 8);
+
+    const auto& lhs = static_cast<Convolutional&>(full_cnn.layer(0));
+    const auto& rhs = static_cast<Convolutional&>(checkpointed_cnn.layer(0));
+
+    bool is_same_cnn = true;
+    for (Core::size_type f = 0; f < lhs.Ws_.size(); ++f)
+        for (Core::size_type i = 0; i < lhs.Ws_[f].size(); ++i)
+            is_same_cnn = is_same_cnn && lhs.Ws_[f].data()[i] == rhs.Ws_[f].data()[i];
+
+    EXPECT("convolutional", is_same_cnn && checkpointed_cnn.layer(1).value().size() == 0);
+}
+
+using FConvolutional = trixy::layer::FConvolutional<Net>;
+
+TEST(TestNeuro, TestFusion)
+{
+    Uniform random(17);
+
+    Net net;
+    net.add(new FullyConnected(8, 16))
+       .add(new FullyConnected(16, 12, new ReLU))
+       .add(new FullyConnected(12, 12))
+       .add(new FullyConnected(12, 10))
+       .add(new FullyConnected(10, 4));
+
+    net.init(trixy::functional::InitializationId::he_uniform, 6);
+
+    Core::Container<Core::Tensor> samples(8);
+    for (auto& sample : samples) sample.resize(1, 1, 8).fill(random);
+
+    Core::Container<Core::Tensor> expected;
+    for (const auto& sample : samples) expected.emplace_back(net.feedforward(sample));
+
+    // linear chain after ReLU is folded to the single layer
+    trixy::Fuser<Net> fuser(net);
+    EXPECT("fold", fuser.fuse() == 3 && net.size() == 2 && net.layer(1).isize().size == 12);
+
+    bool is_close = true;
+    for (Core::size_type i = 0; i < samples.size(); ++i)
+    {
+        const auto& y = net.feedforward(samples[i]);
+        for (Core::size_type j = 0; j < y.size(); ++j)
+            is_close = is_close && std::fabs(y(j) - expected[i](j)) < 1e-5f * (1.f + std::fabs(expected[i](j)));
+    }
+
+    EXPECT("fold value", is_close);
+
+    // 32 x 32 folded weights are larger than 32 x 2 + 2 x 32
+    Net bottleneck;
+    bottleneck.add(new FullyConnected(32, 2))
+              .add(new FullyConnected(2, 32));
+
+    EXPECT("bottleneck", trixy::Fuser<Net>(bottleneck).fuse() == 0 && bottleneck.size() == 2);
+
+    Net cnn;
+    cnn.add(new XConvolutional(Input(2, 6, 6), Filter(3, 3, 3), Padding(1)))
+       .add(new XMaxPooling(Input(3, 6, 6), Stride(2), new ReLU))
+       .add(new XConvolutional(Input(3, 3, 3), Filter(2, 2, 2)))
+       .add(new XMaxPooling(Input(2, 2, 2), Stride(1), new ReLU));
+
+    cnn.init([&random] { return random(); });
+
+    Core::Container<Core::Tensor> images(4);
+    for (auto& image : images) image.resize(Input(2, 6, 6)).fill(random);
+
+    Core::Container<Core::Tensor> values;
+    for (const auto& image : images) values.emplace_back(cnn.feedforward(image));
+
+    EXPECT("pool", trixy::Fuser<Net>(cnn).fuse() == 2 && cnn.size() == 2 &&
+                   dynamic_cast<FConvolutional*>(&cnn.layer(0)) != nullptr);
+
+    // the same sums in the same order
+    bool is_same = true;
+    for (Core::size_type i = 0; i < images.size(); ++i)
+    {
+        const auto& y = cnn.feedforward(images[i]);
+
+        is_same = is_same && y.size() == values[i].size();
+        for (Core::size_type j = 0; j < y.size() && is_same; ++j) is_same = y(j) == values[i](j);
+    }
+
+    EXPECT("pool value", is_same);
+
+    auto& layer = static_cast<FConvolutional&>(cnn.layer(0));
+
+    std::vector<unsigned char> storage;
+    {
+        auto archive = sf::oarchive(storage);
+        archive & layer;
+    }
+
+    FConvolutional loaded;
+    {
+        auto archive = sf::iarchive(storage);
+        archive & loaded;
+    }
+
+    loaded.connect(new ReLU);
+
+    Core::Tensor output(loaded.osize());
+
+    layer.forward(images[0]);
+    loaded.forward(images[0], output);
+
+    bool is_loaded = output.size() == layer.value().size();
+    for (Core::size_type j = 0; j < output.size() && is_loaded; ++j) is_loaded = output(j) == layer.value()(j);
+
+    EXPECT("serialization", is_loaded);
+}
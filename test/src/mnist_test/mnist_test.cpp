@@ -5,22 +5,23 @@
 // Serializer, Tensor, Linear, Container, Random
 
 #include <debug_tools.hpp> // Timer, operator<<
-#include <mnist_test/mnist_reader.hpp> // read_dataset
 
 #include <iostream> // cin, cout
 #include <iomanip> // setprecision, fixed
 #include <fstream> // ifstream, ofstream
-#include <vector> // vector
+#include <algorithm> // min
 
 using Core = trixy::TypeSet<float>;
 using Net = trixy::TrixyNet<Core>;
 
 using FullyConnected = trixy::layer::FullyConnected<Net>;
+using QFullyConnected = trixy::layer::QFullyConnected<Net>;
 
 using ReLU = trixy::functional::activation::ReLU<Core::precision_type>;
 using SoftMax = trixy::functional::activation::SoftMax<Core::precision_type>;
+using Identity = trixy::functional::activation::Identity<Core::precision_type>;
 
-using CCE = trixy::functional::loss::CCE<Core::precision_type>;
+using SoftmaxCrossEntropy = trixy::functional::loss::SoftmaxCrossEntropy<Core::precision_type>;
 
 void show_image(const Core::Tensor& image) noexcept
 {
@@ -53,59 +54,36 @@ void test_image_batch(Net& net, Core::Container<Core::Tensor>& data, Core::Conta
     }
 }
 
-Core::Container<Core::Tensor> get_idata(
-    const std::vector<std::vector<unsigned char>>& data, std::size_t batch_size, std::size_t input_size)
+// Convert 'batch_size' first samples of the mapped IDX file
+Core::Container<Core::Tensor> get_data(const trixy::data::IdxFile& file, std::size_t batch_size)
 {
-    Core::Container<Core::Tensor> input_batch;
-    input_batch.reserve(batch_size);
+    Core::Container<Core::Tensor> batch;
+    if (not file.is_open()) return batch;
 
-    if (data.empty()) return input_batch;
+    file.load(0, std::min(batch_size, file.size()), batch);
 
-    for (Core::size_type i = 0; i < batch_size; ++i)
-        input_batch.emplace_back(1, 1, input_size);
-
-    for (Core::size_type i = 0; i < batch_size; ++i)
-        for (Core::size_type j = 0; j < input_size; ++j)
-            input_batch[i](j) = data[i][j] / 255.0;
-
-    return input_batch;
-}
-
-Core::Container<Core::Tensor> get_odata(
-    const std::vector<unsigned char>& data, std::size_t batch_size, std::size_t output_size)
-{
-    Core::Container<Core::Tensor> output_batch;
-    output_batch.reserve(batch_size);
-
-    if (data.empty()) return output_batch;
-
-    for(Core::size_type i = 0; i < batch_size; ++i)
-        output_batch.emplace_back(1, 1, output_size);
-
-    for (Core::size_type i = 0; i < batch_size; ++i)
-        for (Core::size_type j = 0; j < output_size; ++j)
-            output_batch[i](j) = (data[i] == j) ? 1.0 : 0.0;
-
-    return output_batch;
+    return batch;
 }
 
 void mnist_test_deserialization()
 {
     // Data preparing:
-    auto dataset = mnist::read_dataset("mnist");
+    auto training_images = trixy::data::IdxFile("mnist/train-images-idx3-ubyte").dequantize(1. / 255.);
+    auto training_labels = trixy::data::IdxFile("mnist/train-labels-idx1-ubyte").one_hot(10);
+
+    auto test_images = trixy::data::IdxFile("mnist/t10k-images-idx3-ubyte").dequantize(1. / 255.);
+    auto test_labels = trixy::data::IdxFile("mnist/t10k-labels-idx1-ubyte").one_hot(10);
 
     Core::size_type train_batch_size = 60000; // max 60 000
     Core::size_type test_batch_size  = 10000;
-    Core::size_type input_size  = 784;
-    Core::size_type output_size = 10;
 
     // Train batch initialize:
-    auto train_idata = get_idata(dataset.training_images, train_batch_size, input_size);
-    auto train_odata = get_odata(dataset.training_labels, train_batch_size, output_size);
+    auto train_idata = get_data(training_images, train_batch_size);
+    auto train_odata = get_data(training_labels, train_batch_size);
 
     // Test batch initialize:
-    auto test_idata = get_idata(dataset.test_images, test_batch_size, input_size);
-    auto test_odata = get_odata(dataset.test_labels, test_batch_size, output_size);
+    auto test_idata = get_data(test_images, test_batch_size);
+    auto test_odata = get_data(test_labels, test_batch_size);
 
     std::ifstream file("mnist_test.bin", std::ios::binary);
     if (not file.is_open()) return;
@@ -121,9 +99,9 @@ void mnist_test_deserialization()
     trixy::Checker<Net> check(net);
     //
     std::cout << "NEURO TRAIN_SET ACCURACY: " << check.accuracy(train_idata, train_odata)
-              << "\nNEURO TRAIN_SET LOSS: " << check.loss(train_idata, train_odata, CCE()) << '\n'
+              << "\nNEURO TRAIN_SET LOSS: " << check.loss(train_idata, train_odata, SoftmaxCrossEntropy()) << '\n'
               << "NEURO TEST_SET ACCURACY: " << check.accuracy(test_idata, test_odata)
-              << "\nNEURO TEST_SET LOSS: " << check.loss(test_idata, test_odata, CCE()) << '\n';
+              << "\nNEURO TEST_SET LOSS: " << check.loss(test_idata, test_odata, SoftmaxCrossEntropy()) << '\n';
     //
     //
     std::cout << "TESTING TRAIN_SET\n";
@@ -137,11 +115,12 @@ void mnist_test_deserialization()
 
 void mnist_test()
 {
-    trixy::utility::RandomFloating<Core::precision_type> random;
-    auto generator = [&random] { return random(-0.25f, 0.25f); };
-
     // Data preparing:
-    auto dataset = mnist::read_dataset("mnist");
+    auto training_images = trixy::data::IdxFile("mnist/train-images-idx3-ubyte").dequantize(1. / 255.);
+    auto training_labels = trixy::data::IdxFile("mnist/train-labels-idx1-ubyte").one_hot(10);
+
+    auto test_images = trixy::data::IdxFile("mnist/t10k-images-idx3-ubyte").dequantize(1. / 255.);
+    auto test_labels = trixy::data::IdxFile("mnist/t10k-labels-idx1-ubyte").one_hot(10);
 
     Core::size_type train_batch_size = 60000; // max 60 000
     Core::size_type test_batch_size  = 10000;
@@ -149,12 +128,12 @@ void mnist_test()
     Core::size_type output_size = 10;
 
     // Train batch initialize:
-    auto train_idata = get_idata(dataset.training_images, train_batch_size, input_size);
-    auto train_odata = get_odata(dataset.training_labels, train_batch_size, output_size);
+    auto train_idata = get_data(training_images, train_batch_size);
+    auto train_odata = get_data(training_labels, train_batch_size);
 
     // Test batch initialize:
-    auto test_idata = get_idata(dataset.test_images, test_batch_size, input_size);
-    auto test_odata = get_odata(dataset.test_labels, test_batch_size, output_size);
+    auto test_idata = get_data(test_images, test_batch_size);
+    auto test_odata = get_data(test_labels, test_batch_size);
 
     // Show image:
     //show_image_batch(train_file);
@@ -163,18 +142,26 @@ void mnist_test()
     Net net;
 
     net.add(new FullyConnected(input_size, 256, new ReLU))
-       .add(new FullyConnected(256, output_size, new SoftMax));
+       .add(new FullyConnected(256, output_size, new Identity)); // logits for fused loss
 
-    net.init(generator);
+    net.init(trixy::functional::InitializationId::he_uniform, trixy::utility::DefaultGenerator::seed());
 
     // Train network:
     trixy::train::Training<Net> teach(net);
     trixy::Checker<Net> check(net);
 
-    teach.loss(new CCE);
+    teach.loss(new SoftmaxCrossEntropy);
 
     auto optimizer = trixy::train::AdamOptimizer(net, 0.01f);
 
+    // background checkpoint for each 1000 updates, keeps 2 last files
+    trixy::Checkpoint<Net> checkpoint("mnist_test_checkpoint");
+    teach.checkpoint(&checkpoint, 1000);
+
+
+    // shuffled mini-batches are prepared by 2 background workers
+    trixy::data::DataLoader<Core, trixy::data::IdxFile> loader(training_images, training_labels, 10, 2);
+    loader.shuffle(1);
 
     Timer t;
     //
@@ -182,7 +169,7 @@ void mnist_test()
     for (Core::size_type i = 1; i <= times; ++i)
     {
         std::cout << "start train [" << i << "]:\n";
-        teach.mini_batch(train_idata, train_odata, optimizer, 1, 10);
+        teach.mini_batch(loader, optimizer, 1);
         std::cout << "Accuracy: " << check.accuracy(train_idata, train_odata) << '\n';
     }
     std::cout << "Train time: " << t.elapsed() << '\n';
@@ -208,15 +195,106 @@ void mnist_test()
     std::cout << "End of serialization\n";
 }
 
+void mnist_test_large_batch()
+{
+    // Data preparing:
+    auto training_images = trixy::data::IdxFile("mnist/train-images-idx3-ubyte").dequantize(1. / 255.);
+    auto training_labels = trixy::data::IdxFile("mnist/train-labels-idx1-ubyte").one_hot(10);
+
+    auto test_images = trixy::data::IdxFile("mnist/t10k-images-idx3-ubyte").dequantize(1. / 255.);
+    auto test_labels = trixy::data::IdxFile("mnist/t10k-labels-idx1-ubyte").one_hot(10);
+
+    auto train_idata = get_data(training_images, 60000);
+    auto train_odata = get_data(training_labels, 60000);
+
+    auto test_idata = get_data(test_images, 10000);
+    auto test_odata = get_data(test_labels, 10000);
+
+    Net net;
+
+    net.add(new FullyConnected(784, 256, new ReLU))
+       .add(new FullyConnected(256, 10, new Identity));
+
+    net.init(trixy::functional::InitializationId::he_uniform, trixy::utility::DefaultGenerator::seed());
+
+    trixy::train::Training<Net> teach(net);
+    trixy::Checker<Net> check(net);
+
+    teach.loss(new SoftmaxCrossEntropy);
+
+    // 58 updates per epoch, trust ratios keep the large learning rate stable
+    auto optimizer = trixy::train::LAMBOptimizer(net, 0.02f);
+    optimizer.weight_decay(0.01f);
+
+    Timer t;
+    //
+    Core::size_type times = 10;
+    for (Core::size_type i = 1; i <= times; ++i)
+    {
+        teach.mini_batch(train_idata, train_odata, optimizer, 1, 1024);
+        std::cout << "Large batch epoch [" << i << "] accuracy: " << check.accuracy(train_idata, train_odata) << '\n';
+    }
+    std::cout << "Train time: " << t.elapsed() << '\n';
+
+    std::cout << "Network test set normal accuracy: " << check.accuracy(test_idata, test_odata) << '\n';
+}
+
+void mnist_test_quantization()
+{
+    auto training_images = trixy::data::IdxFile("mnist/train-images-idx3-ubyte").dequantize(1. / 255.);
+
+    auto test_images = trixy::data::IdxFile("mnist/t10k-images-idx3-ubyte").dequantize(1. / 255.);
+    auto test_labels = trixy::data::IdxFile("mnist/t10k-labels-idx1-ubyte").one_hot(10);
+
+    auto calibration_idata = get_data(training_images, 1000);
+
+    auto test_idata = get_data(test_images, 10000);
+    auto test_odata = get_data(test_labels, 10000);
+
+    std::ifstream file("mnist_test.bin", std::ios::binary);
+    if (not file.is_open()) return;
+
+    Net net;
+
+    trixy::Serializer<Net> sr;
+    sr.deserialize(file, net);
+
+    file.close();
+
+    trixy::Checker<Net> check(net);
+
+    const double accuracy = check.accuracy(test_idata, test_odata);
+
+    // ranges of the layer inputs are taken from the part of train set
+    trixy::Quantizer<Net> quantizer(net);
+    quantizer.calibrate(calibration_idata);
+    quantizer.quantize();
+
+    const double quantized_accuracy = check.accuracy(test_idata, test_odata);
+
+    std::cout << "Float test set accuracy: " << accuracy << '\n'
+              << "Int8 test set accuracy: " << quantized_accuracy << '\n'
+              << "Accuracy delta: " << quantized_accuracy - accuracy << '\n';
+
+    std::ofstream quantized_file("mnist_test_int8.bin", std::ios::binary);
+    if (not quantized_file.is_open()) return;
+
+    sr.serialize(quantized_file, net);
+}
+
 TEST(TestExample, TestMNIST)
 {
     return;
     sf::serializable<FullyConnected>();
+    sf::serializable<QFullyConnected>();
     sf::serializable<ReLU>();
     sf::serializable<SoftMax>();
+    sf::serializable<Identity>();
 
     std::cout << std::fixed << std::setprecision(6);
 
     mnist_test();
     mnist_test_deserialization();
+    mnist_test_large_batch();
+    mnist_test_quantization();
 }
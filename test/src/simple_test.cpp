@@ -63,6 +63,19 @@ void simple_test_deserialization()
     statistic(net, idata, odata);
 }
 
+void simple_test_mapped_deserialization()
+{
+    Net net;
+
+    trixy::MappedSerializer<Net> sr;
+    if (not sr.deserialize("simple_test.map", net)) return;
+
+    auto idata = get_simple_test_idata();
+    auto odata = get_simple_test_odata();
+
+    statistic(net, idata, odata);
+}
+
 void simple_test()
 {
     trixy::utility::RandomFloating<Core::precision_type> random;
@@ -101,6 +114,14 @@ void simple_test()
     sr.serialize(file, net);
 
     file.close();
+
+    std::ofstream mapped_file("simple_test.map", std::ios::binary);
+    if (not mapped_file.is_open()) return;
+
+    trixy::MappedSerializer<Net> msr;
+    msr.serialize(mapped_file, net);
+
+    mapped_file.close();
 }
 
 TEST(TestExample, TestSimple)
@@ -113,4 +134,5 @@ TEST(TestExample, TestSimple)
 
     simple_test();
     simple_test_deserialization();
+    simple_test_mapped_deserialization();
 }
@@ -0,0 +1,88 @@
+#include <TrixyTestingBase.hpp>
+
+#include <Trixy/Core.hpp>
+// TrixyNet, Pruning, Linear, Tensor, Random
+
+#include <debug_tools.hpp> // Timer
+
+#include <iostream> // cout
+#include <iomanip> // setw, setprecision, fixed
+
+using Core = trixy::TypeSet<float>;
+using Net = trixy::TrixyNet<Core>;
+
+using SFullyConnected = trixy::layer::SFullyConnected<Net>;
+
+// S = H . W over raw rows of W, each input scales one contiguous row, so the inner loop is vectorized.
+// Unlike Linear::dot, it has no aliasing through operator(), so it's a fair dense baseline
+void dense_dot(float* result, const float* input, const float* W, std::size_t isize, std::size_t osize)
+{
+    for (std::size_t i = 0; i < osize; ++i) result[i] = 0.f;
+
+    for (std::size_t j = 0; j < isize; ++j)
+    {
+        const float x = input[j];
+        const float* row = W + j * osize;
+
+        for (std::size_t i = 0; i < osize; ++i) result[i] += x * row[i];
+    }
+}
+
+// Time of one 1024 x 1024 fully connected forward in us: Linear::dot of the dense layer,
+// the vectorized dense kernel and the 4x1 block sparse layer after block pruning
+void sparse_benchmark()
+{
+    const std::size_t size = 1024;
+    const std::size_t repeat = 100;
+
+    trixy::utility::RandomFloating<float, trixy::utility::Xoshiro256> random(3);
+
+    Core::Tensor input(1, 1, size);
+    for (std::size_t i = 0; i < size; ++i) input(i) = random(0.f, 1.f);
+
+    Core::Tensor output(1, 1, size);
+
+    Core::Vector B(size);
+    B.fill(0.f);
+
+    Core::Linear linear;
+
+    std::cout << "sparsity  stored zero  Linear::dot  dense  sparse\n";
+
+    const double sparsities[] = { 0., 0.5, 0.6, 0.7, 0.8, 0.9, 0.95, 0.98 };
+    for (double sparsity : sparsities)
+    {
+        Core::Matrix W(size, size);
+        for (std::size_t i = 0; i < W.size(); ++i) W.data()[i] = random(-0.05f, 0.05f);
+
+        trixy::layer::detail::prune(W.data(), size, size, trixy::lique::SparseMatrix<float>::block, sparsity);
+
+        Timer t;
+        for (std::size_t r = 0; r < repeat; ++r) linear.dot(output, input, W);
+        const double linear_time = t.elapsed();
+
+        t.reset();
+        for (std::size_t r = 0; r < repeat; ++r) dense_dot(output.data(), input.data(), W.data(), size, size);
+        const double dense_time = t.elapsed();
+
+        SFullyConnected layer(B, W);
+
+        t.reset();
+        for (std::size_t r = 0; r < repeat; ++r) layer.forward(input, output);
+        const double sparse_time = t.elapsed();
+
+        const double us = 1e6 / static_cast<double>(repeat);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << sparsity << std::setw(13) << layer.sparsity()
+                  << std::setprecision(1)
+                  << std::setw(13) << linear_time * us
+                  << std::setw(7) << dense_time * us
+                  << std::setw(8) << sparse_time * us << '\n';
+    }
+}
+
+TEST(TestExample, TestSparseBenchmark)
+{
+    sparse_benchmark();
+}